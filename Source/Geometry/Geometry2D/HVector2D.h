@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../VectorND.h"
+#include "../../_Matrix/MatrixExpression.h"
 
 namespace LCNMath {
 	namespace Geometry {
@@ -11,8 +12,60 @@ namespace LCNMath {
 
 			using LCNMath::Geometry::MatrixN1;
 
+			////////////////////////////////////
+			//-- Homogeneous 2D expressions --//
+			////////////////////////////////////
+
+			template<typename T>
+			struct HVector2D;
+
+			// Lazy homogeneous vector : the 3 components are only computed
+			// when the expression is assigned to an HVector2D or read.
+			template<class E, typename T>
+			class HVector2DExpression : public MatrixExpression<E, T>
+			{
+			public:
+				using ValType = T;
+
+				T operator[](size_t i) const { return this->Derived()[i]; }
+				T operator()(size_t i, size_t) const { return this->Derived()[i]; }
+
+				constexpr size_t Line()   const { return 3; }
+				constexpr size_t Column() const { return 1; }
+
+				HVector2D<T> Eval() const { return HVector2D<T>(*this); }
+
+				// Squared length of x and y
+				T Norm() const
+				{
+					const E& e = this->Derived();
+
+					return e[0] * e[0] + e[1] * e[1];
+				}
+
+				T PX() const { return (*this)[0] / (*this)[2]; }
+				T PY() const { return (*this)[1] / (*this)[2]; }
+
+				HVector2D<T> NormalVector() const { return { -(*this)[1], (*this)[0] }; }
+			};
+
+			// Operands of the expression nodes : vectors are held by reference, nested
+			// expressions by value so that a temporary node cannot dangle. An expression
+			// over a temporary vector must still be assigned before the end of the statement.
+			template<class E>
+			struct HVector2DOperand
+			{
+				using Type = const E;
+			};
+
+			template<typename T>
+			struct HVector2DOperand<HVector2D<T>>
+			{
+				using Type = const HVector2D<T>&;
+			};
+
 			template<typename T>
-			struct HVector2D
+			struct HVector2D : public HVector2DExpression<HVector2D<T>, T>
 			{
 				union
 				{
@@ -27,19 +80,17 @@ namespace LCNMath {
 				};
 
 				HVector2D() :
-					mat(1.0f)
+					mat(T(1))
 				{}
 
 				HVector2D(T _x, T _y) :
 					x(_x),
 					y(_y)
 				{
-					mat(2, 0) = 1.0f;
+					mat(2, 0) = T(1);
 				}
 
-				HVector2D(const HVector2D& vec) :
-					mat(vec.mat)
-				{}
+				HVector2D(const HVector2D&) = default;
 
 				HVector2D(const Vector3D<T>& _mat) :
 					mat(_mat)
@@ -49,12 +100,19 @@ namespace LCNMath {
 					mat(_mat)
 				{}
 
-				inline float PX() const
+				template<class E>
+				HVector2D(const HVector2DExpression<E, T>& e) :
+					x(e[0]),
+					y(e[1]),
+					s(e[2])
+				{}
+
+				inline T PX() const
 				{
 					return x / s;
 				}
 
-				inline float PY() const
+				inline T PY() const
 				{
 					return y / s;
 				}
@@ -63,7 +121,7 @@ namespace LCNMath {
 				{
 					x /= s;
 					y /= s;
-					s = 1.0f;
+					s = T(1);
 				}
 
 				HVector2D NormalVector() const
@@ -71,62 +129,131 @@ namespace LCNMath {
 					return { -y, x };
 				}
 
-				HVector2D& operator=(const HVector2D& vec)
+				HVector2D& operator=(const HVector2D&) = default;
+
+				template<class E>
+				HVector2D& operator=(const HVector2DExpression<E, T>& e)
 				{
-					mat = vec.mat;
+					// Read everything first, e may refer to this vector
+					T _x = e[0], _y = e[1], _s = e[2];
+
+					x = _x;
+					y = _y;
+					s = _s;
 
 					return *this;
 				}
+
+				T operator[](size_t i) const { return mat(i, 0); }
+				T operator()(size_t i, size_t) const { return mat(i, 0); }
 			};
 
-			template<typename T>
-			T operator|(const HVector2D<T>& a, const HVector2D<T>& b)
+			static_assert(std::is_trivially_copyable<HVector2D<float>>::value, "HVector2D must remain trivially copyable.");
+
+			template<class EL, class ER, typename T>
+			T operator|(const HVector2DExpression<EL, T>& a, const HVector2DExpression<ER, T>& b)
 			{
-				// TODO : Quick fix
-				//return a.mat | b.mat;
-				return a.x * b.x + a.y * b.y;
+				return a[0] * b[0] + a[1] * b[1];
 			}
 
-			template<typename T>
-			HVector2D<T> operator+(const HVector2D<T>& a, const HVector2D<T>& b)
+			//////////////////
+			//-- Addition --//
+			//////////////////
+
+			// Point + vector : the result is a point
+			template<class EL, class ER, typename T>
+			class HVector2DAdd : public HVector2DExpression<HVector2DAdd<EL, ER, T>, T>
 			{
-				HVector2D<T> result = a.mat + b.mat;
+			private:
+				typename HVector2DOperand<EL>::Type el;
+				typename HVector2DOperand<ER>::Type er;
+
+				HVector2DAdd(const EL& el, const ER& er) :
+					el(el),
+					er(er)
+				{}
+
+				template<class EL, class ER, typename T>
+				friend HVector2DAdd<EL, ER, T> operator+(const HVector2DExpression<EL, T>&, const HVector2DExpression<ER, T>&);
 
-				result.s = 1.0f;
+			public:
+				T operator[](size_t i) const { return i < 2 ? el[i] + er[i] : T(1); }
+			};
 
-				return result;
+			template<class EL, class ER, typename T>
+			HVector2DAdd<EL, ER, T> operator+(const HVector2DExpression<EL, T>& a, const HVector2DExpression<ER, T>& b)
+			{
+				return HVector2DAdd<EL, ER, T>(static_cast<const EL&>(a), static_cast<const ER&>(b));
 			}
 
-			template<typename T>
-			HVector2D<T> operator-(const HVector2D<T>& a, const HVector2D<T>& b)
+			//////////////////////
+			//-- Substraction --//
+			//////////////////////
+
+			// Point - point : the result is a vector
+			template<class EL, class ER, typename T>
+			class HVector2DSub : public HVector2DExpression<HVector2DSub<EL, ER, T>, T>
 			{
-				HVector2D<T> result = a.mat - b.mat;
+			private:
+				typename HVector2DOperand<EL>::Type el;
+				typename HVector2DOperand<ER>::Type er;
 
-				result.s = 0.0f;
+				HVector2DSub(const EL& el, const ER& er) :
+					el(el),
+					er(er)
+				{}
+
+				template<class EL, class ER, typename T>
+				friend HVector2DSub<EL, ER, T> operator-(const HVector2DExpression<EL, T>&, const HVector2DExpression<ER, T>&);
 
-				return result;
+			public:
+				T operator[](size_t i) const { return i < 2 ? el[i] - er[i] : T(0); }
+			};
+
+			template<class EL, class ER, typename T>
+			HVector2DSub<EL, ER, T> operator-(const HVector2DExpression<EL, T>& a, const HVector2DExpression<ER, T>& b)
+			{
+				return HVector2DSub<EL, ER, T>(static_cast<const EL&>(a), static_cast<const ER&>(b));
 			}
 
-			template<typename T>
-			HVector2D<T> operator*(T t, const HVector2D<T>& vec)
+			/////////////////
+			//-- Scaling --//
+			/////////////////
+
+			// Scales x and y, s is left untouched
+			template<class E, typename T>
+			class HVector2DScale : public HVector2DExpression<HVector2DScale<E, T>, T>
 			{
-				HVector2D<T> result(vec);
+			private:
+				typename HVector2DOperand<E>::Type e;
+				T scalefactor;
 
-				for (uint i = 0; i < 2; i++)
-					result.mat(i, 0) *= t;
+				HVector2DScale(const E& e, T scalefactor) :
+					e(e),
+					scalefactor(scalefactor)
+				{}
 
-				return result;
-			}
+				template<class E, typename T>
+				friend HVector2DScale<E, T> operator*(typename HVector2DExpression<E, T>::ValType, const HVector2DExpression<E, T>&);
 
-			template<typename T>
-			HVector2D<T> operator/(const HVector2D<T>& vec, T t)
-			{
-				HVector2D<T> result(vec);
+				template<class E, typename T>
+				friend HVector2DScale<E, T> operator/(const HVector2DExpression<E, T>&, typename HVector2DExpression<E, T>::ValType);
+
+			public:
+				T operator[](size_t i) const { return i < 2 ? scalefactor * e[i] : e[i]; }
+			};
 
-				for (uint i = 0; i < 2; i++)
-					result.mat(i, 0) /= t;
+			// T is only deduced from the vector : 0.5 * v or v / 2 convert the scalar
+			template<class E, typename T>
+			HVector2DScale<E, T> operator*(typename HVector2DExpression<E, T>::ValType t, const HVector2DExpression<E, T>& vec)
+			{
+				return HVector2DScale<E, T>(static_cast<const E&>(vec), t);
+			}
 
-				return result;
+			template<class E, typename T>
+			HVector2DScale<E, T> operator/(const HVector2DExpression<E, T>& vec, typename HVector2DExpression<E, T>::ValType t)
+			{
+				return HVector2DScale<E, T>(static_cast<const E&>(vec), T(1) / t);
 			}
 		}
 	}
@@ -4,6 +4,10 @@
 
 #include "../../Matrix/Stack/SqrSMatrix.h"
 #include "../../Utilities/Angles.h"
+#include "../../Utilities/Trigonometry.h"
+#include "../../Utilities/Instrumentation.h"
+
+#include "HVector2D.h"
 
 namespace LCNMath {
 	namespace Geometry {
@@ -15,6 +19,8 @@ namespace LCNMath {
 			template<typename T>
 			using SqrSMatrix33 = LCNMath::Matrix::StaticMatrix::SqrMatrix<T, 3>;
 
+			using LCNMath::Trigonometry::TrigMode;
+
 			template<typename T>
 			union Transform2D
 			{
@@ -68,19 +74,40 @@ namespace LCNMath {
 					}
 				}
 
-				Transform2D& operator=(const Transform2D& other)
+				Transform2D(const Transform2D&) = default;
+
+				Transform2D& operator=(const Transform2D&) = default;
+
+				// a in degrees
+				void SetRotationAngle(T a, TrigMode mode = TrigMode::Exact)
+				{
+					T s, c;
+
+					if (mode == TrigMode::Fast)
+						LCNMath::Trigonometry::FastSinCos(LCNMath::Angles::ToRad(a), s, c);
+					else
+						LCNMath::Trigonometry::SinCos(LCNMath::Angles::ToRad(a), s, c);
+
+					SetRotation(s, c);
+				}
+
+				// Angle of step * 360 / Steps degrees, read from a precomputed table
+				template<size_t Steps>
+				void SetRotationStep(int64_t step)
 				{
-					mat = other.mat;
+					T s, c;
 
-					return *this;
+					LCNMath::Trigonometry::SinCosTable<T, Steps>::Get().SinCos(step, s, c);
+
+					SetRotation(s, c);
 				}
 
-				void SetRotationAngle(float a)
+				void SetRotation(T s, T c)
 				{
-					Rux =  std::cos(TORAD(a));
-					Ruy =  std::sin(TORAD(a));
-					Rvx = -std::sin(TORAD(a));
-					Rvy =  std::cos(TORAD(a));
+					Rux =  c;
+					Ruy =  s;
+					Rvx = -s;
+					Rvy =  c;
 				}
 
 				void SetTranslation(T x, T y)
@@ -89,6 +116,45 @@ namespace LCNMath {
 					Ty = y;
 				}
 			};
+
+			static_assert(std::is_trivially_copyable<Transform2D<float>>::value, "Transform2D must remain trivially copyable.");
+
+			// Both bottom lines are [0 0 1] : 12 multiplications instead of 27
+			template<typename T>
+			Transform2D<T> operator*(const Transform2D<T>& a, const Transform2D<T>& b)
+			{
+				LCN_INSTRUMENT("Transform2D::Compose", 3, 3, 20, 18 * sizeof(T));
+
+				Transform2D<T> result;
+
+				result.Rux = a.Rux * b.Rux + a.Rvx * b.Ruy;
+				result.Rvx = a.Rux * b.Rvx + a.Rvx * b.Rvy;
+				result.Tx  = a.Rux * b.Tx  + a.Rvx * b.Ty + a.Tx;
+
+				result.Ruy = a.Ruy * b.Rux + a.Rvy * b.Ruy;
+				result.Rvy = a.Ruy * b.Rvx + a.Rvy * b.Rvy;
+				result.Ty  = a.Ruy * b.Tx  + a.Rvy * b.Ty + a.Ty;
+
+				return result;
+			}
+
+			// s is preserved, no homogeneous division is needed. Any vector expression is
+			// evaluated first.
+			template<class E, typename T>
+			HVector2D<T> operator*(const Transform2D<T>& t, const HVector2DExpression<E, T>& e)
+			{
+				LCN_INSTRUMENT("Transform2D::Apply", 3, 1, 10, 9 * sizeof(T));
+
+				const HVector2D<T> v(e);
+
+				HVector2D<T> result;
+
+				result.x = t.Rux * v.x + t.Rvx * v.y + t.Tx * v.s;
+				result.y = t.Ruy * v.x + t.Rvy * v.y + t.Ty * v.s;
+				result.s = v.s;
+
+				return result;
+			}
 		}
 	}
 }
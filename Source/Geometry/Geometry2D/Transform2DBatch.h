@@ -0,0 +1,211 @@
+#pragma once
+
+#include "Transform2D.h"
+#include "../../Utilities/SIMD.h"
+#include "../../Utilities/Trigonometry.h"
+#include "../../Utilities/Instrumentation.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim2 {
+
+			////////////////////////////
+			//-- Batch construction --//
+			////////////////////////////
+
+			// out[i] = Transform2D(x[i], y[i], a[i]), angles in degrees
+			template<typename T>
+			void MakeTransforms(const T* x, const T* y, const T* a, Transform2D<T>* out, size_t count, TrigMode mode = TrigMode::Exact)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out[i] = Transform2D<T>();
+
+					out[i].SetTranslation(x[i], y[i]);
+					out[i].SetRotationAngle(a[i], mode);
+				}
+			}
+
+#ifdef LCN_SSE
+			inline void MakeTransforms(const float* x, const float* y, const float* a, Transform2D<float>* out, size_t count, TrigMode mode = TrigMode::Exact)
+			{
+				size_t i = 0;
+
+				// Sines and cosines of 4 angles per iteration
+				if (mode == TrigMode::Fast)
+				{
+					const __m128 torad = _mm_set1_ps(LCNMath::Angles::ToRad(1.0f));
+
+					for (; i + 4 <= count; i += 4)
+					{
+						__m128 s, c;
+
+						LCNMath::Trigonometry::FastSinCos(_mm_mul_ps(_mm_loadu_ps(a + i), torad), s, c);
+
+						float sines[4], cosines[4];
+
+						_mm_storeu_ps(sines,   s);
+						_mm_storeu_ps(cosines, c);
+
+						for (size_t k = 0; k < 4; ++k)
+						{
+							out[i + k] = Transform2D<float>();
+
+							out[i + k].SetTranslation(x[i + k], y[i + k]);
+							out[i + k].SetRotation(sines[k], cosines[k]);
+						}
+					}
+				}
+
+				for (; i < count; ++i)
+				{
+					out[i] = Transform2D<float>();
+
+					out[i].SetTranslation(x[i], y[i]);
+					out[i].SetRotationAngle(a[i], mode);
+				}
+			}
+#endif
+
+			////////////////////////////
+			//-- Transform chaining --//
+			////////////////////////////
+
+			// Single transform equivalent to applying chain[0], then chain[1], ...
+			template<typename T>
+			Transform2D<T> Compose(const Transform2D<T>* chain, size_t count)
+			{
+				Transform2D<T> result;
+
+				for (size_t i = 0; i < count; ++i)
+					result = chain[i] * result;
+
+				return result;
+			}
+
+			////////////////////////////
+			//-- Batched transforms --//
+			////////////////////////////
+
+			// Points stored as separate x and y arrays (SoA).
+			// Output arrays may be the input ones.
+			template<typename T>
+			void Apply(const Transform2D<T>& t, const T* x, const T* y, T* outx, T* outy, size_t count)
+			{
+				LCN_INSTRUMENT("Transform2D::ApplyBatch", count, 2, 8 * count, 4 * count * sizeof(T));
+
+				const T Rux = t.Rux, Rvx = t.Rvx, Tx = t.Tx;
+				const T Ruy = t.Ruy, Rvy = t.Rvy, Ty = t.Ty;
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					T px = x[i];
+					T py = y[i];
+
+					outx[i] = Rux * px + Rvx * py + Tx;
+					outy[i] = Ruy * px + Rvy * py + Ty;
+				}
+			}
+
+			// Points stored as interleaved x, y pairs : xy holds 2 * count values.
+			// The output array may be the input one.
+			template<typename T>
+			void Apply(const Transform2D<T>& t, const T* xy, T* outxy, size_t count)
+			{
+				LCN_INSTRUMENT("Transform2D::ApplyBatch", count, 2, 8 * count, 4 * count * sizeof(T));
+
+				const T Rux = t.Rux, Rvx = t.Rvx, Tx = t.Tx;
+				const T Ruy = t.Ruy, Rvy = t.Rvy, Ty = t.Ty;
+
+				for (size_t i = 0; i < 2 * count; i += 2)
+				{
+					T px = xy[i];
+					T py = xy[i + 1];
+
+					outxy[i]     = Rux * px + Rvx * py + Tx;
+					outxy[i + 1] = Ruy * px + Rvy * py + Ty;
+				}
+			}
+
+			template<typename T>
+			void Apply(const Transform2D<T>& t, const HVector2D<T>* in, HVector2D<T>* out, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = t * in[i];
+			}
+
+#ifdef LCN_SSE
+			inline void Apply(const Transform2D<float>& t, const float* x, const float* y, float* outx, float* outy, size_t count)
+			{
+				LCN_INSTRUMENT("Transform2D::ApplyBatch", count, 2, 8 * count, 4 * count * sizeof(float));
+
+				const __m128 Rux = _mm_set1_ps(t.Rux), Rvx = _mm_set1_ps(t.Rvx), Tx = _mm_set1_ps(t.Tx);
+				const __m128 Ruy = _mm_set1_ps(t.Ruy), Rvy = _mm_set1_ps(t.Rvy), Ty = _mm_set1_ps(t.Ty);
+
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 px = _mm_loadu_ps(x + i);
+					__m128 py = _mm_loadu_ps(y + i);
+
+					_mm_storeu_ps(outx + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(Rux, px), _mm_mul_ps(Rvx, py)), Tx));
+					_mm_storeu_ps(outy + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(Ruy, px), _mm_mul_ps(Rvy, py)), Ty));
+				}
+
+				for (; i < count; ++i)
+				{
+					float px = x[i];
+					float py = y[i];
+
+					outx[i] = t.Rux * px + t.Rvx * py + t.Tx;
+					outy[i] = t.Ruy * px + t.Rvy * py + t.Ty;
+				}
+			}
+
+			inline void Apply(const Transform2D<float>& t, const float* xy, float* outxy, size_t count)
+			{
+				LCN_INSTRUMENT("Transform2D::ApplyBatch", count, 2, 8 * count, 4 * count * sizeof(float));
+
+				// Two points per register : (x0, y0, x1, y1)
+				const __m128 Ru = _mm_setr_ps(t.Rux, t.Ruy, t.Rux, t.Ruy);
+				const __m128 Rv = _mm_setr_ps(t.Rvx, t.Rvy, t.Rvx, t.Rvy);
+				const __m128 Tr = _mm_setr_ps(t.Tx,  t.Ty,  t.Tx,  t.Ty);
+
+				size_t i = 0;
+
+				for (; i + 2 <= count; i += 2)
+				{
+					__m128 p  = _mm_loadu_ps(xy + 2 * i);
+					__m128 px = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+					__m128 py = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+
+					_mm_storeu_ps(outxy + 2 * i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(Ru, px), _mm_mul_ps(Rv, py)), Tr));
+				}
+
+				if (i < count)
+				{
+					float px = xy[2 * i];
+					float py = xy[2 * i + 1];
+
+					outxy[2 * i]     = t.Rux * px + t.Rvx * py + t.Tx;
+					outxy[2 * i + 1] = t.Ruy * px + t.Rvy * py + t.Ty;
+				}
+			}
+#endif
+
+			// Applies the whole chain in a single pass over the points
+			template<typename T>
+			void Apply(const Transform2D<T>* chain, size_t chainlength, const T* x, const T* y, T* outx, T* outy, size_t count)
+			{
+				Apply(Compose(chain, chainlength), x, y, outx, outy, count);
+			}
+
+			template<typename T>
+			void Apply(const Transform2D<T>* chain, size_t chainlength, const T* xy, T* outxy, size_t count)
+			{
+				Apply(Compose(chain, chainlength), xy, outxy, count);
+			}
+		}
+	}
+}
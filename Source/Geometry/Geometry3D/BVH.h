@@ -0,0 +1,229 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+#include "BoundingVolume.h"
+#include "../../Utilities/Async.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			/////////////
+			//-- BVH --//
+			/////////////
+
+			// Bounding volume hierarchy over an array of boxes. Nodes are stored in a single
+			// array in depth first order : the left child of a node is the next node, and each
+			// node keeps the index of the node following its subtree (Skip). Traversal is then
+			// a forward walk over the array without stack : descend on a hit, skip on a miss.
+			template<typename T>
+			class BVH
+			{
+			public:
+				struct Node
+				{
+					AABB<T>  Box;
+					uint32_t Skip;   // First node after this subtree
+					uint32_t First;  // Leaf : first primitive in Indices()
+					uint32_t Count;  // Leaf : number of primitives, 0 for internal nodes
+				};
+
+				static constexpr size_t LeafSize = 4;
+
+				// Subtrees with more primitives than this are built in parallel, on the shared
+				// pool, down to about twice as many subtrees as the pool has threads
+				static constexpr size_t ParallelThreshold = 4096;
+
+				BVH() = default;
+
+				BVH(const AABB<T>* boxes, size_t count, bool parallel = true)
+				{
+					this->Build(boxes, count, parallel);
+				}
+
+				void Build(const AABB<T>* boxes, size_t count, bool parallel = true)
+				{
+					m_Indices.resize(count);
+					std::iota(m_Indices.begin(), m_Indices.end(), uint32_t(0));
+
+					std::vector<T> centers(3 * count);
+
+					for (size_t i = 0; i < count; ++i)
+						for (int k = 0; k < 3; ++k)
+							centers[3 * i + k] = boxes[i].Center(k);
+
+					// A subtree over n primitives has at most 2n - 1 nodes : every subtree is
+					// written at a fixed offset of a single array, whose gaps are removed after
+					m_Nodes.assign(count ? 2 * count - 1 : 0, Node{});
+
+					size_t depth   = 0;
+					size_t threads = Async::ThreadPool::Shared().Size();
+
+					if (parallel && threads > 1)
+						while ((size_t(1) << depth) < 2 * threads)
+							depth++;
+
+					if (count)
+						this->BuildRange(boxes, centers.data(), 0, count, 0, uint32_t(m_Nodes.size()), depth);
+
+					this->Compact();
+
+					// Leaves test the boxes of their primitives in a contiguous range
+					m_Boxes.resize(count);
+
+					for (size_t p = 0; p < count; ++p)
+						m_Boxes[p] = boxes[m_Indices[p]];
+				}
+
+				const std::vector<Node>&     Nodes()   const { return m_Nodes; }
+				const std::vector<uint32_t>& Indices() const { return m_Indices; }
+
+				// Calls hit(index) for every primitive whose box, and the boxes of its ancestors, pass test(box)
+				template<class Test, class F>
+				void Traverse(Test test, F hit) const
+				{
+					size_t i = 0;
+
+					while (i < m_Nodes.size())
+					{
+						const Node& node = m_Nodes[i];
+
+						if (!test(node.Box))
+						{
+							i = node.Skip;
+							continue;
+						}
+
+						for (uint32_t p = node.First; p < node.First + node.Count; ++p)
+							if (test(m_Boxes[p]))
+								hit(m_Indices[p]);
+
+						i = node.Count ? node.Skip : i + 1;
+					}
+				}
+
+				// Primitives whose box overlaps box
+				template<class F>
+				void Query(const AABB<T>& box, F hit) const
+				{
+					this->Traverse([&box](const AABB<T>& b) { return b.Intersects(box); }, hit);
+				}
+
+				// Primitives whose box contains point
+				template<class F>
+				void Query(const HVector3D<T>& point, F hit) const
+				{
+					this->Traverse([&point](const AABB<T>& b) { return b.Contains(point); }, hit);
+				}
+
+				// Primitives whose box is hit by the ray for a parameter in [0, tmax]
+				template<class F>
+				void Query(const Ray<T>& ray, F hit, T tmax = std::numeric_limits<T>::max()) const
+				{
+					this->Traverse([&ray, tmax](const AABB<T>& b) { T tnear; return Intersect(ray, b, tmax, tnear); }, hit);
+				}
+
+			private:
+				// Subtree over m_Indices[first, last) written from m_Nodes[offset], next being the
+				// node that follows it in the traversal. Unused nodes keep Skip = 0.
+				void BuildRange(const AABB<T>* boxes, const T* centers, size_t first, size_t last, size_t offset, uint32_t next, size_t depth)
+				{
+					Node& node = m_Nodes[offset];
+
+					node.Box = AABB<T>::Empty();
+
+					AABB<T> centroids = AABB<T>::Empty();
+
+					for (size_t p = first; p < last; ++p)
+					{
+						const T* c = centers + 3 * m_Indices[p];
+
+						node.Box.Extend(boxes[m_Indices[p]]);
+
+						for (int k = 0; k < 3; ++k)
+						{
+							centroids.Min[k] = std::min(centroids.Min[k], c[k]);
+							centroids.Max[k] = std::max(centroids.Max[k], c[k]);
+						}
+					}
+
+					int axis = centroids.LargestAxis();
+
+					if (last - first <= LeafSize || centroids.Max[axis] == centroids.Min[axis])
+					{
+						node.Skip  = next;
+						node.First = uint32_t(first);
+						node.Count = uint32_t(last - first);
+
+						return;
+					}
+
+					// Median split along the largest extent of the centroids
+					size_t middle = (first + last) / 2;
+
+					std::nth_element(m_Indices.begin() + first, m_Indices.begin() + middle, m_Indices.begin() + last,
+						[centers, axis](uint32_t a, uint32_t b) { return centers[3 * a + axis] < centers[3 * b + axis]; });
+
+					node.Skip  = next;
+					node.First = 0;
+					node.Count = 0;
+
+					// The left child follows its parent, the right one starts after the room of
+					// the left subtree
+					size_t right = offset + 2 * (middle - first);
+
+					// The two halves work on disjoint ranges of m_Indices and m_Nodes
+					if (depth > 0 && last - first > ParallelThreshold)
+					{
+						Async::Invoke(Async::ThreadPool::Shared(),
+							[this, boxes, centers, first, middle, offset, right, depth] { this->BuildRange(boxes, centers, first, middle, offset + 1, uint32_t(right), depth - 1); },
+							[this, boxes, centers, middle, last, right, next, depth]     { this->BuildRange(boxes, centers, middle, last, right, next, depth - 1); });
+					}
+					else
+					{
+						this->BuildRange(boxes, centers, first, middle, offset + 1, uint32_t(right), 0);
+						this->BuildRange(boxes, centers, middle, last, right, next, 0);
+					}
+				}
+
+				// Removes the unused nodes, Skip becoming the index of the first node after the subtree
+				void Compact()
+				{
+					std::vector<uint32_t> index(m_Nodes.size() + 1);
+
+					uint32_t used = 0;
+
+					for (size_t i = 0; i < m_Nodes.size(); ++i)
+					{
+						index[i] = used;
+
+						if (m_Nodes[i].Skip != 0)
+							used++;
+					}
+
+					index[m_Nodes.size()] = used;
+
+					for (size_t i = 0; i < m_Nodes.size(); ++i)
+						if (m_Nodes[i].Skip != 0)
+						{
+							Node node = m_Nodes[i];
+
+							node.Skip = index[node.Skip];
+							m_Nodes[index[i]] = node;
+						}
+
+					m_Nodes.resize(used);
+					m_Nodes.shrink_to_fit();
+				}
+
+				std::vector<Node>     m_Nodes;
+				std::vector<uint32_t> m_Indices;
+				std::vector<AABB<T>>  m_Boxes;
+			};
+		}
+	}
+}
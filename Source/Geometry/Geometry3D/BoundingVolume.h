@@ -0,0 +1,390 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+#include "Transform3D.h"
+#include "../../Utilities/SIMD.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			//////////////
+			//-- AABB --//
+			//////////////
+
+			// Axis aligned box, kept trivially copyable so that arrays of them can be
+			// copied and streamed as raw memory.
+			template<typename T>
+			struct AABB
+			{
+				T Min[3];
+				T Max[3];
+
+				// Contains nothing : extending it by anything gives the bounds of that thing
+				static AABB Empty()
+				{
+					AABB result;
+
+					for (int k = 0; k < 3; ++k)
+					{
+						result.Min[k] = std::numeric_limits<T>::max();
+						result.Max[k] = std::numeric_limits<T>::lowest();
+					}
+
+					return result;
+				}
+
+				void Extend(const HVector3D<T>& p)
+				{
+					const T c[3] = { p.x, p.y, p.z };
+
+					for (int k = 0; k < 3; ++k)
+					{
+						Min[k] = std::min(Min[k], c[k]);
+						Max[k] = std::max(Max[k], c[k]);
+					}
+				}
+
+				void Extend(const AABB& box)
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						Min[k] = std::min(Min[k], box.Min[k]);
+						Max[k] = std::max(Max[k], box.Max[k]);
+					}
+				}
+
+				bool Contains(const HVector3D<T>& p) const
+				{
+					return p.x >= Min[0] && p.x <= Max[0]
+					    && p.y >= Min[1] && p.y <= Max[1]
+					    && p.z >= Min[2] && p.z <= Max[2];
+				}
+
+				bool Intersects(const AABB& box) const
+				{
+					return Min[0] <= box.Max[0] && box.Min[0] <= Max[0]
+					    && Min[1] <= box.Max[1] && box.Min[1] <= Max[1]
+					    && Min[2] <= box.Max[2] && box.Min[2] <= Max[2];
+				}
+
+				T Center(int axis) const { return (Min[axis] + Max[axis]) / T(2); }
+
+				T SurfaceArea() const
+				{
+					T dx = Max[0] - Min[0], dy = Max[1] - Min[1], dz = Max[2] - Min[2];
+
+					return T(2) * (dx * dy + dy * dz + dz * dx);
+				}
+
+				int LargestAxis() const
+				{
+					T dx = Max[0] - Min[0], dy = Max[1] - Min[1], dz = Max[2] - Min[2];
+
+					return (dx >= dy && dx >= dz) ? 0 : (dy >= dz ? 1 : 2);
+				}
+			};
+
+			static_assert(std::is_trivially_copyable<AABB<float>>::value, "AABB must remain trivially copyable.");
+
+			// Bounds of the transformed box (absolute matrix trick) : the center is transformed,
+			// the half extents are multiplied by the absolute values of the linear part.
+			template<typename T>
+			AABB<T> operator*(const Transform3D<T>& t, const AABB<T>& box)
+			{
+				using std::abs;
+
+				const T M[3][4] = { { t.Rux, t.Rvx, t.Rwx, t.Tx },
+				                    { t.Ruy, t.Rvy, t.Rwy, t.Ty },
+				                    { t.Ruz, t.Rvz, t.Rwz, t.Tz } };
+
+				T c[3], e[3];
+
+				for (int k = 0; k < 3; ++k)
+				{
+					c[k] = (box.Min[k] + box.Max[k]) / T(2);
+					e[k] = (box.Max[k] - box.Min[k]) / T(2);
+				}
+
+				AABB<T> result;
+
+				for (int i = 0; i < 3; ++i)
+				{
+					T center = M[i][0] * c[0] + M[i][1] * c[1] + M[i][2] * c[2] + M[i][3];
+					T extent = abs(M[i][0]) * e[0] + abs(M[i][1]) * e[1] + abs(M[i][2]) * e[2];
+
+					result.Min[i] = center - extent;
+					result.Max[i] = center + extent;
+				}
+
+				return result;
+			}
+
+			/////////////
+			//-- OBB --//
+			/////////////
+
+			template<typename T>
+			struct OBB
+			{
+				T Center[3];
+				T Axis[3][3];     // Axis[k] is the unit direction of HalfExtent[k]
+				T HalfExtent[3];
+
+				bool Contains(const HVector3D<T>& p) const
+				{
+					using std::abs;
+
+					const T d[3] = { p.x - Center[0], p.y - Center[1], p.z - Center[2] };
+
+					for (int k = 0; k < 3; ++k)
+						if (abs(d[0] * Axis[k][0] + d[1] * Axis[k][1] + d[2] * Axis[k][2]) > HalfExtent[k])
+							return false;
+
+					return true;
+				}
+
+				AABB<T> Bounds() const
+				{
+					using std::abs;
+
+					AABB<T> result;
+
+					for (int i = 0; i < 3; ++i)
+					{
+						T extent = abs(Axis[0][i]) * HalfExtent[0] + abs(Axis[1][i]) * HalfExtent[1] + abs(Axis[2][i]) * HalfExtent[2];
+
+						result.Min[i] = Center[i] - extent;
+						result.Max[i] = Center[i] + extent;
+					}
+
+					return result;
+				}
+			};
+
+			static_assert(std::is_trivially_copyable<OBB<float>>::value, "OBB must remain trivially copyable.");
+
+			// Exact image of the box : the columns of the linear part become the axes,
+			// their norms scale the half extents.
+			template<typename T>
+			OBB<T> MakeOBB(const Transform3D<T>& t, const AABB<T>& box)
+			{
+				using std::sqrt;
+
+				const T columns[3][3] = { { t.Rux, t.Ruy, t.Ruz },
+				                          { t.Rvx, t.Rvy, t.Rvz },
+				                          { t.Rwx, t.Rwy, t.Rwz } };
+
+				OBB<T> result;
+
+				T c[3];
+
+				for (int k = 0; k < 3; ++k)
+					c[k] = (box.Min[k] + box.Max[k]) / T(2);
+
+				result.Center[0] = t.Rux * c[0] + t.Rvx * c[1] + t.Rwx * c[2] + t.Tx;
+				result.Center[1] = t.Ruy * c[0] + t.Rvy * c[1] + t.Rwy * c[2] + t.Ty;
+				result.Center[2] = t.Ruz * c[0] + t.Rvz * c[1] + t.Rwz * c[2] + t.Tz;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					T norm = sqrt(columns[k][0] * columns[k][0] + columns[k][1] * columns[k][1] + columns[k][2] * columns[k][2]);
+
+					for (int i = 0; i < 3; ++i)
+						result.Axis[k][i] = columns[k][i] / norm;
+
+					result.HalfExtent[k] = norm * (box.Max[k] - box.Min[k]) / T(2);
+				}
+
+				return result;
+			}
+
+			/////////////
+			//-- Ray --//
+			/////////////
+
+			template<typename T>
+			struct Ray
+			{
+				T Origin[3];
+				T InvDirection[3];  // Null direction components give infinities, which the slab test handles
+
+				Ray(const HVector3D<T>& origin, const HVector3D<T>& direction)
+				{
+					Origin[0] = origin.x;
+					Origin[1] = origin.y;
+					Origin[2] = origin.z;
+
+					InvDirection[0] = T(1) / direction.x;
+					InvDirection[1] = T(1) / direction.y;
+					InvDirection[2] = T(1) / direction.z;
+				}
+			};
+
+			// Slab test : the ray hits the box for a parameter in [0, tmax], the entry one goes to tnear
+			template<typename T>
+			bool Intersect(const Ray<T>& ray, const AABB<T>& box, T tmax, T& tnear)
+			{
+				T t0 = T(0);
+				T t1 = tmax;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					T a = (box.Min[k] - ray.Origin[k]) * ray.InvDirection[k];
+					T b = (box.Max[k] - ray.Origin[k]) * ray.InvDirection[k];
+
+					// 0 * inf : the ray runs inside a slab plane, which bounds nothing
+					if (std::isnan(a) || std::isnan(b))
+						continue;
+
+					t0 = std::max(t0, std::min(a, b));
+					t1 = std::min(t1, std::max(a, b));
+				}
+
+				tnear = t0;
+
+				return t0 <= t1;
+			}
+
+			///////////////////////////
+			//-- Batched operators --//
+			///////////////////////////
+
+			// result[i] = t * boxes[i], result may alias boxes
+			template<typename T>
+			void Transform(const Transform3D<T>& t, const AABB<T>* boxes, AABB<T>* result, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = t * boxes[i];
+			}
+
+			// inside[i] = box contains points[i]
+			template<typename T>
+			void Contains(const AABB<T>& box, const HVector3D<T>* points, uint8_t* inside, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					inside[i] = box.Contains(points[i]);
+			}
+
+			// hit[i] = the ray hits boxes[i] for a parameter in [0, tmax]
+			template<typename T>
+			void Intersect(const Ray<T>& ray, const AABB<T>* boxes, uint8_t* hit, size_t count, T tmax = std::numeric_limits<T>::max())
+			{
+				T tnear;
+
+				for (size_t i = 0; i < count; ++i)
+					hit[i] = Intersect(ray, boxes[i], tmax, tnear);
+			}
+
+#ifdef LCN_SSE
+			inline void Transform(const Transform3D<float>& t, const AABB<float>* boxes, AABB<float>* result, size_t count)
+			{
+				const __m128 sign = _mm_set1_ps(-0.0f);
+
+				// Columns of the linear part, their absolute values, and the translation
+				const __m128 u = _mm_setr_ps(t.Rux, t.Ruy, t.Ruz, 0.0f);
+				const __m128 v = _mm_setr_ps(t.Rvx, t.Rvy, t.Rvz, 0.0f);
+				const __m128 w = _mm_setr_ps(t.Rwx, t.Rwy, t.Rwz, 0.0f);
+				const __m128 o = _mm_setr_ps(t.Tx,  t.Ty,  t.Tz,  0.0f);
+
+				const __m128 au = _mm_andnot_ps(sign, u);
+				const __m128 av = _mm_andnot_ps(sign, v);
+				const __m128 aw = _mm_andnot_ps(sign, w);
+
+				const __m128 half = _mm_set1_ps(0.5f);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const AABB<float>& box = boxes[i];
+
+					__m128 mn = _mm_setr_ps(box.Min[0], box.Min[1], box.Min[2], 0.0f);
+					__m128 mx = _mm_setr_ps(box.Max[0], box.Max[1], box.Max[2], 0.0f);
+
+					__m128 c = _mm_mul_ps(_mm_add_ps(mn, mx), half);
+					__m128 e = _mm_mul_ps(_mm_sub_ps(mx, mn), half);
+
+					__m128 center = _mm_add_ps(o, _mm_add_ps(_mm_add_ps(
+						_mm_mul_ps(u, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0))),
+						_mm_mul_ps(v, _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)))),
+						_mm_mul_ps(w, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2)))));
+
+					__m128 extent = _mm_add_ps(_mm_add_ps(
+						_mm_mul_ps(au, _mm_shuffle_ps(e, e, _MM_SHUFFLE(0, 0, 0, 0))),
+						_mm_mul_ps(av, _mm_shuffle_ps(e, e, _MM_SHUFFLE(1, 1, 1, 1)))),
+						_mm_mul_ps(aw, _mm_shuffle_ps(e, e, _MM_SHUFFLE(2, 2, 2, 2))));
+
+					float lo[4], hi[4];
+
+					_mm_storeu_ps(lo, _mm_sub_ps(center, extent));
+					_mm_storeu_ps(hi, _mm_add_ps(center, extent));
+
+					std::copy(lo, lo + 3, result[i].Min);
+					std::copy(hi, hi + 3, result[i].Max);
+				}
+			}
+
+			// HVector3D<float> is exactly one __m128 : (x, y, z, s), s is ignored
+			inline void Contains(const AABB<float>& box, const HVector3D<float>* points, uint8_t* inside, size_t count)
+			{
+				const __m128 mn = _mm_setr_ps(box.Min[0], box.Min[1], box.Min[2], 0.0f);
+				const __m128 mx = _mm_setr_ps(box.Max[0], box.Max[1], box.Max[2], 0.0f);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					__m128 p = _mm_loadu_ps(&points[i].x);
+
+					int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(p, mn), _mm_cmple_ps(p, mx)));
+
+					inside[i] = (mask & 7) == 7;
+				}
+			}
+
+			// 4 boxes at a time, one per lane
+			inline void Intersect(const Ray<float>& ray, const AABB<float>* boxes, uint8_t* hit, size_t count, float tmax = std::numeric_limits<float>::max())
+			{
+				size_t i = 0;
+
+				const __m128 limit = _mm_set1_ps(tmax);
+
+				for (; i + 4 <= count; i += 4)
+				{
+					const AABB<float>* b = boxes + i;
+
+					__m128 t0 = _mm_setzero_ps();
+					__m128 t1 = limit;
+
+					for (int k = 0; k < 3; ++k)
+					{
+						__m128 origin = _mm_set1_ps(ray.Origin[k]);
+						__m128 inv    = _mm_set1_ps(ray.InvDirection[k]);
+
+						__m128 a = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(b[0].Min[k], b[1].Min[k], b[2].Min[k], b[3].Min[k]), origin), inv);
+						__m128 c = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(b[0].Max[k], b[1].Max[k], b[2].Max[k], b[3].Max[k]), origin), inv);
+
+						// Lanes of a NaN slab (0 * inf) are turned to NaN, which max/min drop in favour
+						// of their second operand, as the scalar version skips them
+						__m128 nan = _mm_cmpunord_ps(a, c);
+
+						t0 = _mm_max_ps(_mm_or_ps(_mm_min_ps(a, c), nan), t0);
+						t1 = _mm_min_ps(_mm_or_ps(_mm_max_ps(a, c), nan), t1);
+					}
+
+					int mask = _mm_movemask_ps(_mm_cmple_ps(t0, t1));
+
+					for (int l = 0; l < 4; ++l)
+						hit[i + l] = (mask >> l) & 1;
+				}
+
+				float tnear;
+
+				for (; i < count; ++i)
+					hit[i] = Intersect(ray, boxes[i], tmax, tnear);
+			}
+#endif
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Frustum.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			////////////////
+			//-- Camera --//
+			////////////////
+
+			// View and projection with their product and its frustum cached. Setting either
+			// recomputes both, so that const accessors only read and a camera can be shared by
+			// threads while nobody sets it. Version() changes with every set, so that per object
+			// caches built on the view-projection know when to refresh.
+			template<typename T>
+			class Camera
+			{
+			public:
+				Camera(DepthRange range = DepthRange::NegativeOneToOne) :
+					m_Range(range)
+				{
+					this->Update();
+				}
+
+				const Transform3D<T>&  View()       const { return m_View; }
+				const Projective3D<T>& Projection() const { return m_Projection; }
+
+				DepthRange Range()   const { return m_Range; }
+				uint64_t   Version() const { return m_Version; }
+
+				void SetView(const Transform3D<T>& view)
+				{
+					m_View = view;
+					this->Update();
+					m_Version++;
+				}
+
+				void SetProjection(const Projective3D<T>& projection)
+				{
+					m_Projection = projection;
+					this->Update();
+					m_Version++;
+				}
+
+				void LookAt(const HVector3D<T>& eye, const HVector3D<T>& target, const HVector3D<T>& up)
+				{
+					this->SetView(Dim3::LookAt(eye, target, up));
+				}
+
+				void SetPerspective(T fovy, T aspect, T znear, T zfar)
+				{
+					this->SetProjection(Perspective(fovy, aspect, znear, zfar, m_Range));
+				}
+
+				void SetOrthographic(T left, T right, T bottom, T top, T znear, T zfar)
+				{
+					this->SetProjection(Orthographic(left, right, bottom, top, znear, zfar, m_Range));
+				}
+
+				const Projective3D<T>& ViewProjection() const { return m_ViewProjection; }
+
+				// World space planes
+				const Frustum<T>& ViewFrustum() const { return m_Frustum; }
+
+				Projective3D<T> ModelViewProjection(const Transform3D<T>& model) const
+				{
+					return this->ViewProjection() * model;
+				}
+
+				// Incremental update of the model-view-projections of count objects. version is
+				// the camera version result was last computed for : if it is still current, only
+				// the objects flagged in changed are recomputed. version is then brought up to date.
+				void ModelViewProjection(const Transform3D<T>* models, const uint8_t* changed, Projective3D<T>* result, size_t count, uint64_t& version) const
+				{
+					const Projective3D<T>& vp = this->ViewProjection();
+
+					if (version != m_Version)
+					{
+						Compose(vp, models, result, count);
+						version = m_Version;
+						return;
+					}
+
+					for (size_t i = 0; i < count; ++i)
+						if (changed[i])
+							result[i] = vp * models[i];
+				}
+
+			private:
+				void Update()
+				{
+					m_ViewProjection = m_Projection * m_View;
+					m_Frustum        = ExtractFrustum(m_ViewProjection, m_Range);
+				}
+
+				Transform3D<T>  m_View;
+				Projective3D<T> m_Projection;
+				DepthRange      m_Range;
+				uint64_t        m_Version = 1;
+				Projective3D<T> m_ViewProjection;
+				Frustum<T>      m_Frustum;
+			};
+		}
+	}
+}
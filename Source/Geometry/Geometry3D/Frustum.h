@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Projection.h"
+#include "BoundingVolume.h"
+#include "../../Utilities/SIMD.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			/////////////////
+			//-- Frustum --//
+			/////////////////
+
+			// Six planes a x + b y + c z + d, positive inside, with (a, b, c) of unit length
+			// so that the value is the signed distance to the plane.
+			template<typename T>
+			struct Frustum
+			{
+				enum Plane { Left, Right, Bottom, Top, Near, Far };
+
+				T Planes[6][4];
+
+				T Distance(int plane, const HVector3D<T>& p) const
+				{
+					const T* q = Planes[plane];
+
+					return q[0] * p.x + q[1] * p.y + q[2] * p.z + q[3];
+				}
+
+				bool Contains(const HVector3D<T>& p) const
+				{
+					for (int k = 0; k < 6; ++k)
+						if (this->Distance(k, p) < T(0))
+							return false;
+
+					return true;
+				}
+
+				// Conservative : false only if the box is entirely outside one plane
+				bool Intersects(const AABB<T>& box) const
+				{
+					using std::abs;
+
+					for (int k = 0; k < 6; ++k)
+					{
+						const T* q = Planes[k];
+
+						T center = q[0] * box.Center(0) + q[1] * box.Center(1) + q[2] * box.Center(2) + q[3];
+						T radius = (abs(q[0]) * (box.Max[0] - box.Min[0]) + abs(q[1]) * (box.Max[1] - box.Min[1]) + abs(q[2]) * (box.Max[2] - box.Min[2])) / T(2);
+
+						if (center + radius < T(0))
+							return false;
+					}
+
+					return true;
+				}
+			};
+
+			static_assert(std::is_trivially_copyable<Frustum<float>>::value, "Frustum must remain trivially copyable.");
+
+			// Planes of the clip volume of m, in the space m is applied to (Gribb-Hartmann) :
+			// world space for a view-projection, object space for a model-view-projection.
+			template<typename T>
+			Frustum<T> ExtractFrustum(const Projective3D<T>& m, DepthRange range = DepthRange::NegativeOneToOne)
+			{
+				using std::sqrt;
+
+				const T* r = m.mat.Data();
+
+				Frustum<T> result;
+
+				for (int k = 0; k < 4; ++k)
+				{
+					T x = r[k], y = r[4 + k], z = r[8 + k], w = r[12 + k];
+
+					result.Planes[Frustum<T>::Left][k]   = w + x;
+					result.Planes[Frustum<T>::Right][k]  = w - x;
+					result.Planes[Frustum<T>::Bottom][k] = w + y;
+					result.Planes[Frustum<T>::Top][k]    = w - y;
+					result.Planes[Frustum<T>::Near][k]   = range == DepthRange::NegativeOneToOne ? w + z : z;
+					result.Planes[Frustum<T>::Far][k]    = w - z;
+				}
+
+				for (int p = 0; p < 6; ++p)
+				{
+					T* q = result.Planes[p];
+
+					T inv = T(1) / sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+
+					for (int k = 0; k < 4; ++k)
+						q[k] *= inv;
+				}
+
+				return result;
+			}
+
+			///////////////////////////
+			//-- Batched operators --//
+			///////////////////////////
+
+			// result[i] = frustum of m[i], for several cameras or shadow cascades
+			template<typename T>
+			void ExtractFrustum(const Projective3D<T>* m, Frustum<T>* result, size_t count, DepthRange range = DepthRange::NegativeOneToOne)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = ExtractFrustum(m[i], range);
+			}
+
+			// inside[i] = frustum contains points[i]
+			template<typename T>
+			void Contains(const Frustum<T>& frustum, const HVector3D<T>* points, uint8_t* inside, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					inside[i] = frustum.Contains(points[i]);
+			}
+
+			// visible[i] = boxes[i] may intersect the frustum
+			template<typename T>
+			void Intersect(const Frustum<T>& frustum, const AABB<T>* boxes, uint8_t* visible, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					visible[i] = frustum.Intersects(boxes[i]);
+			}
+
+#ifdef LCN_SSE
+			// Each line of the matrix is one __m128, each plane a sum of two lines
+			inline void ExtractFrustum(const Projective3D<float>* m, Frustum<float>* result, size_t count, DepthRange range = DepthRange::NegativeOneToOne)
+			{
+				const __m128 nearmask = range == DepthRange::NegativeOneToOne ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : _mm_setzero_ps();
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const float* r = m[i].mat.Data();
+
+					__m128 x = _mm_loadu_ps(r);
+					__m128 y = _mm_loadu_ps(r + 4);
+					__m128 z = _mm_loadu_ps(r + 8);
+					__m128 w = _mm_loadu_ps(r + 12);
+
+					__m128 planes[6] = {
+						_mm_add_ps(w, x), _mm_sub_ps(w, x),
+						_mm_add_ps(w, y), _mm_sub_ps(w, y),
+						_mm_add_ps(_mm_and_ps(w, nearmask), z), _mm_sub_ps(w, z)
+					};
+
+					for (int p = 0; p < 6; ++p)
+					{
+						__m128 inv = SIMD::SafeInverseSqrt(SIMD::Dot3(planes[p], planes[p]), SIMD::Precision::Exact);
+
+						_mm_storeu_ps(result[i].Planes[p], _mm_mul_ps(planes[p], inv));
+					}
+				}
+			}
+
+			// 4 points at a time, transposed so that each lane tests one point
+			inline void Contains(const Frustum<float>& frustum, const HVector3D<float>* points, uint8_t* inside, size_t count)
+			{
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 x = _mm_loadu_ps(&points[i].x);
+					__m128 y = _mm_loadu_ps(&points[i + 1].x);
+					__m128 z = _mm_loadu_ps(&points[i + 2].x);
+					__m128 s = _mm_loadu_ps(&points[i + 3].x);
+
+					_MM_TRANSPOSE4_PS(x, y, z, s);
+
+					__m128 in = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+					for (int p = 0; p < 6; ++p)
+					{
+						const float* q = frustum.Planes[p];
+
+						__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(q[0]), x), _mm_mul_ps(_mm_set1_ps(q[1]), y)),
+						                      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(q[2]), z), _mm_set1_ps(q[3])));
+
+						in = _mm_and_ps(in, _mm_cmpge_ps(d, _mm_setzero_ps()));
+					}
+
+					int mask = _mm_movemask_ps(in);
+
+					for (int l = 0; l < 4; ++l)
+						inside[i + l] = (mask >> l) & 1;
+				}
+
+				for (; i < count; ++i)
+					inside[i] = frustum.Contains(points[i]);
+			}
+
+			// 4 boxes at a time : center distance plus projected radius against each plane
+			inline void Intersect(const Frustum<float>& frustum, const AABB<float>* boxes, uint8_t* visible, size_t count)
+			{
+				const __m128 half = _mm_set1_ps(0.5f);
+
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					const AABB<float>* b = boxes + i;
+
+					__m128 c[3], e[3];
+
+					for (int k = 0; k < 3; ++k)
+					{
+						__m128 mn = _mm_setr_ps(b[0].Min[k], b[1].Min[k], b[2].Min[k], b[3].Min[k]);
+						__m128 mx = _mm_setr_ps(b[0].Max[k], b[1].Max[k], b[2].Max[k], b[3].Max[k]);
+
+						c[k] = _mm_mul_ps(_mm_add_ps(mn, mx), half);
+						e[k] = _mm_mul_ps(_mm_sub_ps(mx, mn), half);
+					}
+
+					__m128 in = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+					for (int p = 0; p < 6; ++p)
+					{
+						const float* q = frustum.Planes[p];
+
+						__m128 d = _mm_set1_ps(q[3]);
+
+						for (int k = 0; k < 3; ++k)
+						{
+							d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(q[k]), c[k]));
+							d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(q[k])), e[k]));
+						}
+
+						in = _mm_and_ps(in, _mm_cmpge_ps(d, _mm_setzero_ps()));
+					}
+
+					int mask = _mm_movemask_ps(in);
+
+					for (int l = 0; l < 4; ++l)
+						visible[i + l] = (mask >> l) & 1;
+				}
+
+				for (; i < count; ++i)
+					visible[i] = frustum.Intersects(boxes[i]);
+			}
+#endif
+		}
+	}
+}
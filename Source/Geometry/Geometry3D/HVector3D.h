@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../VectorND.h"
+#include "../../_Matrix/MatrixExpression.h"
+#include "../../Utilities/SIMD.h"
 
 namespace LCNMath {
 	namespace Geometry {
@@ -11,8 +13,64 @@ namespace LCNMath {
 
 			using LCNMath::Geometry::MatrixN1;
 
+			////////////////////////////////////
+			//-- Homogeneous 3D expressions --//
+			////////////////////////////////////
+
 			template<typename T>
-			struct HVector3D
+			struct HVector3D;
+
+			// Lazy homogeneous vector : the 4 components are only computed
+			// when the expression is assigned to an HVector3D or read.
+			template<class E, typename T>
+			class HVector3DExpression : public MatrixExpression<E, T>
+			{
+			public:
+				using ValType = T;
+
+				T operator[](size_t i) const { return this->Derived()[i]; }
+				T operator()(size_t i, size_t) const { return this->Derived()[i]; }
+
+				constexpr size_t Line()   const { return 4; }
+				constexpr size_t Column() const { return 1; }
+
+				HVector3D<T> Eval() const { return HVector3D<T>(*this); }
+
+				// Squared length, as HVector3D::Norm
+				T Norm() const
+				{
+					const E& e = this->Derived();
+
+					return e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+				}
+
+				HVector3D<T> Normalized() const
+				{
+					HVector3D<T> result(*this);
+
+					result.Normalize();
+
+					return result;
+				}
+			};
+
+			// Operands of the expression nodes : vectors are held by reference, nested
+			// expressions by value so that a temporary node cannot dangle. An expression
+			// over a temporary vector must still be assigned before the end of the statement.
+			template<class E>
+			struct HVector3DOperand
+			{
+				using Type = const E;
+			};
+
+			template<typename T>
+			struct HVector3DOperand<HVector3D<T>>
+			{
+				using Type = const HVector3D<T>&;
+			};
+
+			template<typename T>
+			struct HVector3D : public HVector3DExpression<HVector3D<T>, T>
 			{
 				union
 				{
@@ -28,22 +86,20 @@ namespace LCNMath {
 				};
 
 				HVector3D(bool ispoint) :
-					mat(1.0f)
+					mat(T(1))
 				{
-					mat(3, 0) = (ispoint ? 1.0f : 0.0f);
+					mat(3, 0) = (ispoint ? T(1) : T(0));
 				}
 
-				HVector3D(float _x, float _y, float _z, bool ispoint = true) :
+				HVector3D(T _x, T _y, T _z, bool ispoint = true) :
 					x(_x),
 					y(_y),
 					z(_z)
 				{
-					mat(3, 0) = (ispoint ? 1.0f : 0.0f);
+					mat(3, 0) = (ispoint ? T(1) : T(0));
 				}
 
-				HVector3D(const HVector3D& vec) :
-					mat(vec.mat)
-				{}
+				HVector3D(const HVector3D&) = default;
 
 				HVector3D(const Vector4D<T>& _mat) :
 					mat(_mat)
@@ -53,56 +109,79 @@ namespace LCNMath {
 					mat(_mat)
 				{}
 
+				template<class E>
+				HVector3D(const HVector3DExpression<E, T>& e) :
+					x(e[0]),
+					y(e[1]),
+					z(e[2]),
+					s(e[3])
+				{}
+
 				static const HVector3D& X()
 				{
-					static HVector3D x(1.0f, 0.0f, 0.0f, false);
+					static HVector3D x(T(1), T(0), T(0), false);
 					return x;
 				}
 
 				static const HVector3D& Y()
 				{
-					static HVector3D y(0.0f, 1.0f, 0.0f, false);
+					static HVector3D y(T(0), T(1), T(0), false);
 					return y;
 				}
 
 				static const HVector3D& Z()
 				{
-					static HVector3D z(0.0f, 0.0f, 1.0f, false);
+					static HVector3D z(T(0), T(0), T(1), false);
 					return z;
 				}
 
 				static const HVector3D& Zero()
 				{
-					static HVector3D zero(0.0f, 0.0f, 0.0f);
+					static HVector3D zero(T(0), T(0), T(0));
 					return zero;
 				}
 
-				HVector3D& operator=(const HVector3D& vec)
+				HVector3D& operator=(const HVector3D&) = default;
+
+				template<class E>
+				HVector3D& operator=(const HVector3DExpression<E, T>& e)
 				{
-					mat = vec.mat;
+					// Read everything first, e may refer to this vector
+					T _x = e[0], _y = e[1], _z = e[2], _s = e[3];
+
+					x = _x;
+					y = _y;
+					z = _z;
+					s = _s;
 
 					return *this;
 				}
 
+				T operator[](size_t i) const { return mat(i, 0); }
+				T operator()(size_t i, size_t) const { return mat(i, 0); }
+
 				T Norm() const
 				{
 					return x * x + y * y + z * z;
 				}
 
+				// Norm() is the squared length : one reciprocal instead of three divisions
 				void Normalize()
 				{
-					float norm = std::sqrt(Norm());
+					T inv = T(1) / std::sqrt(Norm());
 
-					x /= norm;
-					y /= norm;
-					z /= norm;
+					x *= inv;
+					y *= inv;
+					z *= inv;
 				}
 			};
 
+			static_assert(std::is_trivially_copyable<HVector3D<float>>::value, "HVector3D must remain trivially copyable.");
+
 			template<typename T>
 			HVector3D<T> operator^(const HVector3D<T>& vec1, const HVector3D<T>& vec2)
 			{
-				static HVector3D<T> result(false);
+				HVector3D<T> result(false);
 
 				result.x = vec1.y * vec2.z - vec1.z * vec2.y;
 				result.y = vec1.z * vec2.x - vec1.x * vec2.z;
@@ -111,54 +190,123 @@ namespace LCNMath {
 				return result;
 			}
 
-			template<typename T>
-			T operator|(const HVector3D<T>& vec1, const HVector3D<T>& vec2)
+#ifdef LCN_SSE
+			inline HVector3D<float> operator^(const HVector3D<float>& vec1, const HVector3D<float>& vec2)
 			{
-				// TODO : Quick fix
-				//return vec1.mat | vec2.mat;
-				return vec1.x * vec2.x + vec1.y * vec2.y + vec1.z * vec2.z;
-			}
+				HVector3D<float> result(false);
 
-			template<typename T>
-			HVector3D<T> operator+(const HVector3D<T>& a, const HVector3D<T>& b)
-			{
-				HVector3D<T> result = a.mat + b.mat;
+				_mm_storeu_ps(&result.x, LCNMath::SIMD::Cross3(_mm_loadu_ps(&vec1.x), _mm_loadu_ps(&vec2.x)));
 
-				result.s = 1.0f;
+				result.s = 0.0f;
 
 				return result;
 			}
+#endif
 
-			template<typename T>
-			HVector3D<T> operator-(const HVector3D<T>& a, const HVector3D<T>& b)
+			template<class EL, class ER, typename T>
+			T operator|(const HVector3DExpression<EL, T>& vec1, const HVector3DExpression<ER, T>& vec2)
 			{
-				HVector3D<T> result = a.mat - b.mat;
+				return vec1[0] * vec2[0] + vec1[1] * vec2[1] + vec1[2] * vec2[2];
+			}
 
-				result.s = 0.0f;
+			//////////////////
+			//-- Addition --//
+			//////////////////
 
-				return result;
+			// Point + vector : the result is a point
+			template<class EL, class ER, typename T>
+			class HVector3DAdd : public HVector3DExpression<HVector3DAdd<EL, ER, T>, T>
+			{
+			private:
+				typename HVector3DOperand<EL>::Type el;
+				typename HVector3DOperand<ER>::Type er;
+
+				HVector3DAdd(const EL& el, const ER& er) :
+					el(el),
+					er(er)
+				{}
+
+				template<class EL, class ER, typename T>
+				friend HVector3DAdd<EL, ER, T> operator+(const HVector3DExpression<EL, T>&, const HVector3DExpression<ER, T>&);
+
+			public:
+				T operator[](size_t i) const { return i < 3 ? el[i] + er[i] : T(1); }
+			};
+
+			template<class EL, class ER, typename T>
+			HVector3DAdd<EL, ER, T> operator+(const HVector3DExpression<EL, T>& a, const HVector3DExpression<ER, T>& b)
+			{
+				return HVector3DAdd<EL, ER, T>(static_cast<const EL&>(a), static_cast<const ER&>(b));
 			}
 
-			template<typename T>
-			HVector3D<T> operator*(float t, const HVector3D<T>& vec)
+			//////////////////////
+			//-- Substraction --//
+			//////////////////////
+
+			// Point - point : the result is a vector
+			template<class EL, class ER, typename T>
+			class HVector3DSub : public HVector3DExpression<HVector3DSub<EL, ER, T>, T>
 			{
-				HVector3D<T> result(vec);
+			private:
+				typename HVector3DOperand<EL>::Type el;
+				typename HVector3DOperand<ER>::Type er;
 
-				for (uint i = 0; i < 3; i++)
-					result.mat(i, 0) *= t;
+				HVector3DSub(const EL& el, const ER& er) :
+					el(el),
+					er(er)
+				{}
 
-				return result;
+				template<class EL, class ER, typename T>
+				friend HVector3DSub<EL, ER, T> operator-(const HVector3DExpression<EL, T>&, const HVector3DExpression<ER, T>&);
+
+			public:
+				T operator[](size_t i) const { return i < 3 ? el[i] - er[i] : T(0); }
+			};
+
+			template<class EL, class ER, typename T>
+			HVector3DSub<EL, ER, T> operator-(const HVector3DExpression<EL, T>& a, const HVector3DExpression<ER, T>& b)
+			{
+				return HVector3DSub<EL, ER, T>(static_cast<const EL&>(a), static_cast<const ER&>(b));
 			}
 
-			template<typename T>
-			HVector3D<T> operator/(const HVector3D<T>& vec, float t)
+			/////////////////
+			//-- Scaling --//
+			/////////////////
+
+			// Scales x, y and z, s is left untouched
+			template<class E, typename T>
+			class HVector3DScale : public HVector3DExpression<HVector3DScale<E, T>, T>
 			{
-				HVector3D<T> result(vec);
+			private:
+				typename HVector3DOperand<E>::Type e;
+				T scalefactor;
 
-				for (uint i = 0; i < 3; i++)
-					result.mat(i, 0) /= t;
+				HVector3DScale(const E& e, T scalefactor) :
+					e(e),
+					scalefactor(scalefactor)
+				{}
 
-				return result;
+				template<class E, typename T>
+				friend HVector3DScale<E, T> operator*(typename HVector3DExpression<E, T>::ValType, const HVector3DExpression<E, T>&);
+
+				template<class E, typename T>
+				friend HVector3DScale<E, T> operator/(const HVector3DExpression<E, T>&, typename HVector3DExpression<E, T>::ValType);
+
+			public:
+				T operator[](size_t i) const { return i < 3 ? scalefactor * e[i] : e[i]; }
+			};
+
+			// T is only deduced from the vector : 0.5 * v or v / 2 convert the scalar
+			template<class E, typename T>
+			HVector3DScale<E, T> operator*(typename HVector3DExpression<E, T>::ValType t, const HVector3DExpression<E, T>& vec)
+			{
+				return HVector3DScale<E, T>(static_cast<const E&>(vec), t);
+			}
+
+			template<class E, typename T>
+			HVector3DScale<E, T> operator/(const HVector3DExpression<E, T>& vec, typename HVector3DExpression<E, T>::ValType t)
+			{
+				return HVector3DScale<E, T>(static_cast<const E&>(vec), T(1) / t);
 			}
 		}
 	}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cmath>
+
+#include "HVector3D.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			///////////////////////////
+			//-- Batched operators --//
+			///////////////////////////
+
+			// result[i] = a[i] | b[i]
+			template<typename T>
+			void Dot(const HVector3D<T>* a, const HVector3D<T>* b, T* result, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = a[i].x * b[i].x + a[i].y * b[i].y + a[i].z * b[i].z;
+			}
+
+			// result[i] = a[i] ^ b[i], result may alias a or b
+			template<typename T>
+			void Cross(const HVector3D<T>* a, const HVector3D<T>* b, HVector3D<T>* result, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					T x = a[i].y * b[i].z - a[i].z * b[i].y;
+					T y = a[i].z * b[i].x - a[i].x * b[i].z;
+					T z = a[i].x * b[i].y - a[i].y * b[i].x;
+
+					result[i].x = x;
+					result[i].y = y;
+					result[i].z = z;
+					result[i].s = T(0);
+				}
+			}
+
+			// result[i] = length of a[i]. Fast precision only changes the float kernels.
+			template<typename T>
+			void Length(const HVector3D<T>* a, T* result, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = std::sqrt(a[i].Norm());
+			}
+
+			// result[i] = a[i] / length, s is kept and null vectors stay null. result may alias a.
+			template<typename T>
+			void Normalize(const HVector3D<T>* a, HVector3D<T>* result, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					T inv = SIMD::SafeInverseSqrt(a[i].Norm());
+
+					result[i].x = a[i].x * inv;
+					result[i].y = a[i].y * inv;
+					result[i].z = a[i].z * inv;
+					result[i].s = a[i].s;
+				}
+			}
+
+			/////////////////////
+			//-- SoA batches --//
+			/////////////////////
+
+			// Coordinates in separate arrays : result[i] = length of (x[i], y[i], z[i])
+			template<typename T>
+			void Length(const T* x, const T* y, const T* z, T* result, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+			}
+
+			// In place, null vectors stay null
+			template<typename T>
+			void Normalize(T* x, T* y, T* z, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					T inv = SIMD::SafeInverseSqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+
+					x[i] *= inv;
+					y[i] *= inv;
+					z[i] *= inv;
+				}
+			}
+
+#ifdef LCN_SSE
+			// HVector3D<float> is exactly one __m128 : (x, y, z, s)
+			inline void Dot(const HVector3D<float>* a, const HVector3D<float>* b, float* result, size_t count)
+			{
+				size_t i = 0;
+
+				// 4 vectors at a time : transposing the products gives one dot product per lane
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 p0 = _mm_mul_ps(_mm_loadu_ps(&a[i].x),     _mm_loadu_ps(&b[i].x));
+					__m128 p1 = _mm_mul_ps(_mm_loadu_ps(&a[i + 1].x), _mm_loadu_ps(&b[i + 1].x));
+					__m128 p2 = _mm_mul_ps(_mm_loadu_ps(&a[i + 2].x), _mm_loadu_ps(&b[i + 2].x));
+					__m128 p3 = _mm_mul_ps(_mm_loadu_ps(&a[i + 3].x), _mm_loadu_ps(&b[i + 3].x));
+
+					_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+					_mm_storeu_ps(result + i, _mm_add_ps(_mm_add_ps(p0, p1), p2));
+				}
+
+				for (; i < count; ++i)
+					result[i] = _mm_cvtss_f32(LCNMath::SIMD::Dot3(_mm_loadu_ps(&a[i].x), _mm_loadu_ps(&b[i].x)));
+			}
+
+			inline void Cross(const HVector3D<float>* a, const HVector3D<float>* b, HVector3D<float>* result, size_t count)
+			{
+				const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					__m128 c = LCNMath::SIMD::Cross3(_mm_loadu_ps(&a[i].x), _mm_loadu_ps(&b[i].x));
+
+					_mm_storeu_ps(&result[i].x, _mm_and_ps(c, mask));
+				}
+			}
+
+			inline void Length(const HVector3D<float>* a, float* result, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+			{
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 x = _mm_loadu_ps(&a[i].x);
+					__m128 y = _mm_loadu_ps(&a[i + 1].x);
+					__m128 z = _mm_loadu_ps(&a[i + 2].x);
+					__m128 s = _mm_loadu_ps(&a[i + 3].x);
+
+					_MM_TRANSPOSE4_PS(x, y, z, s);
+
+					__m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+					_mm_storeu_ps(result + i, SIMD::Sqrt(squared, precision));
+				}
+
+				for (; i < count; ++i)
+				{
+					__m128 v = _mm_loadu_ps(&a[i].x);
+
+					result[i] = _mm_cvtss_f32(SIMD::Sqrt(SIMD::Dot3(v, v), precision));
+				}
+			}
+
+			// 4 vectors at a time in SoA : one reciprocal square root for 4 lengths
+			inline void Normalize(const HVector3D<float>* a, HVector3D<float>* result, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+			{
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 x = _mm_loadu_ps(&a[i].x);
+					__m128 y = _mm_loadu_ps(&a[i + 1].x);
+					__m128 z = _mm_loadu_ps(&a[i + 2].x);
+					__m128 s = _mm_loadu_ps(&a[i + 3].x);
+
+					_MM_TRANSPOSE4_PS(x, y, z, s);
+
+					__m128 inv = SIMD::SafeInverseSqrt(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), precision);
+
+					x = _mm_mul_ps(x, inv);
+					y = _mm_mul_ps(y, inv);
+					z = _mm_mul_ps(z, inv);
+
+					_MM_TRANSPOSE4_PS(x, y, z, s);
+
+					_mm_storeu_ps(&result[i].x,     x);
+					_mm_storeu_ps(&result[i + 1].x, y);
+					_mm_storeu_ps(&result[i + 2].x, z);
+					_mm_storeu_ps(&result[i + 3].x, s);
+				}
+
+				const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+				for (; i < count; ++i)
+				{
+					__m128 v = _mm_loadu_ps(&a[i].x);
+
+					__m128 scaled = _mm_mul_ps(v, SIMD::SafeInverseSqrt(SIMD::Dot3(v, v), precision));
+
+					_mm_storeu_ps(&result[i].x, _mm_or_ps(_mm_and_ps(mask, scaled), _mm_andnot_ps(mask, v)));
+				}
+			}
+
+			inline void Length(const float* x, const float* y, const float* z, float* result, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+			{
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+
+					__m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+
+					_mm_storeu_ps(result + i, SIMD::Sqrt(squared, precision));
+				}
+
+				for (; i < count; ++i)
+					result[i] = _mm_cvtss_f32(SIMD::Sqrt(_mm_set_ss(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]), precision));
+			}
+
+			inline void Normalize(float* x, float* y, float* z, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+			{
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+
+					__m128 inv = SIMD::SafeInverseSqrt(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)), precision);
+
+					_mm_storeu_ps(x + i, _mm_mul_ps(vx, inv));
+					_mm_storeu_ps(y + i, _mm_mul_ps(vy, inv));
+					_mm_storeu_ps(z + i, _mm_mul_ps(vz, inv));
+				}
+
+				for (; i < count; ++i)
+				{
+					float inv = _mm_cvtss_f32(SIMD::SafeInverseSqrt(_mm_set_ss(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]), precision));
+
+					x[i] *= inv;
+					y[i] *= inv;
+					z[i] *= inv;
+				}
+			}
+#endif
+		}
+	}
+}
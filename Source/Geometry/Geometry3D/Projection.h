@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cmath>
+
+#include "Transform3D.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			// Depth range of clip space after the division by w
+			enum class DepthRange
+			{
+				NegativeOneToOne,  // OpenGL
+				ZeroToOne          // Direct3D, Vulkan
+			};
+
+			///////////////////////
+			//-- Projective 3D --//
+			///////////////////////
+
+			// General 4x4 transform : unlike Transform3D, the last line is not [0 0 0 1].
+			// Coefficients are row major in mat.Data(), points are columns.
+			template<typename T>
+			struct Projective3D
+			{
+				SqrSMatrix44<T> mat;
+
+				Projective3D() :
+					mat(true)
+				{}
+
+				Projective3D(const Projective3D&) = default;
+
+				Projective3D(const SqrSMatrix44<T>& _mat) :
+					mat(_mat)
+				{}
+
+				explicit Projective3D(const Transform3D<T>& t) :
+					mat(t.mat)
+				{}
+
+				Projective3D& operator=(const Projective3D&) = default;
+			};
+
+			static_assert(std::is_trivially_copyable<Projective3D<float>>::value, "Projective3D must remain trivially copyable.");
+
+			// Right handed view space looking down -z, fovy in radians, 0 < znear < zfar
+			template<typename T>
+			Projective3D<T> Perspective(T fovy, T aspect, T znear, T zfar, DepthRange range = DepthRange::NegativeOneToOne)
+			{
+				using std::tan;
+
+				Projective3D<T> result;
+
+				T* m = result.mat.Data();
+				T  f = T(1) / tan(fovy / T(2));
+
+				std::fill(m, m + 16, T(0));
+
+				m[0]  = f / aspect;
+				m[5]  = f;
+				m[14] = T(-1);
+
+				if (range == DepthRange::NegativeOneToOne)
+				{
+					m[10] = (zfar + znear) / (znear - zfar);
+					m[11] = T(2) * zfar * znear / (znear - zfar);
+				}
+				else
+				{
+					m[10] = zfar / (znear - zfar);
+					m[11] = zfar * znear / (znear - zfar);
+				}
+
+				return result;
+			}
+
+			template<typename T>
+			Projective3D<T> Orthographic(T left, T right, T bottom, T top, T znear, T zfar, DepthRange range = DepthRange::NegativeOneToOne)
+			{
+				Projective3D<T> result;
+
+				T* m = result.mat.Data();
+
+				m[0]  = T(2) / (right - left);
+				m[3]  = -(right + left) / (right - left);
+				m[5]  = T(2) / (top - bottom);
+				m[7]  = -(top + bottom) / (top - bottom);
+
+				if (range == DepthRange::NegativeOneToOne)
+				{
+					m[10] = T(-2) / (zfar - znear);
+					m[11] = -(zfar + znear) / (zfar - znear);
+				}
+				else
+				{
+					m[10] = T(-1) / (zfar - znear);
+					m[11] = -znear / (zfar - znear);
+				}
+
+				return result;
+			}
+
+			// View transform of a camera at eye looking at target : a rigid transform, so
+			// a Transform3D. up only has to be non collinear with target - eye.
+			template<typename T>
+			Transform3D<T> LookAt(const HVector3D<T>& eye, const HVector3D<T>& target, const HVector3D<T>& up)
+			{
+				using std::sqrt;
+
+				T f[3] = { target.x - eye.x, target.y - eye.y, target.z - eye.z };
+				T s[3] = { f[1] * up.z - f[2] * up.y, f[2] * up.x - f[0] * up.z, f[0] * up.y - f[1] * up.x };
+
+				T fn = T(1) / sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+				T sn = T(1) / sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+
+				for (int k = 0; k < 3; ++k)
+				{
+					f[k] *= fn;
+					s[k] *= sn;
+				}
+
+				T u[3] = { s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0] };
+
+				Transform3D<T> view;
+
+				view.Rux = s[0];  view.Rvx = s[1];  view.Rwx = s[2];
+				view.Ruy = u[0];  view.Rvy = u[1];  view.Rwy = u[2];
+				view.Ruz = -f[0]; view.Rvz = -f[1]; view.Rwz = -f[2];
+
+				view.Tx = -(s[0] * eye.x + s[1] * eye.y + s[2] * eye.z);
+				view.Ty = -(u[0] * eye.x + u[1] * eye.y + u[2] * eye.z);
+				view.Tz =   f[0] * eye.x + f[1] * eye.y + f[2] * eye.z;
+
+				return view;
+			}
+
+			/////////////////////
+			//-- Composition --//
+			/////////////////////
+
+			template<typename T>
+			Projective3D<T> operator*(const Projective3D<T>& a, const Projective3D<T>& b)
+			{
+				LCN_INSTRUMENT("Projective3D::Compose", 4, 4, 112, 32 * sizeof(T));
+
+				return SqrSMatrix44<T>(a.mat * b.mat);
+			}
+
+			// The last line of t is [0 0 0 1] : 48 multiplications instead of 64
+			template<typename T>
+			Projective3D<T> operator*(const Projective3D<T>& p, const Transform3D<T>& t)
+			{
+				LCN_INSTRUMENT("Projective3D::ComposeAffine", 4, 4, 84, 28 * sizeof(T));
+
+				Projective3D<T> result;
+
+				const T* a = p.mat.Data();
+				const T* b = t.mat.Data();
+				T*       c = result.mat.Data();
+
+				for (int i = 0; i < 4; ++i)
+				{
+					const T* line = a + 4 * i;
+
+					for (int j = 0; j < 4; ++j)
+						c[4 * i + j] = line[0] * b[j] + line[1] * b[4 + j] + line[2] * b[8 + j];
+
+					c[4 * i + 3] += line[3];
+				}
+
+				return result;
+			}
+
+			// Clip coordinates : s receives w, divide by it for normalized device coordinates
+			template<class E, typename T>
+			HVector3D<T> operator*(const Projective3D<T>& p, const HVector3DExpression<E, T>& e)
+			{
+				const HVector3D<T> v(e);
+
+				return p.mat * v.mat;
+			}
+
+			// result[i] = p * models[i], result receives the model-view-projection of each object
+			template<typename T>
+			void Compose(const Projective3D<T>& p, const Transform3D<T>* models, Projective3D<T>* result, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = p * models[i];
+			}
+		}
+	}
+}
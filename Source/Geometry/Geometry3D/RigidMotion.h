@@ -0,0 +1,283 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "Transform3D.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			// Rigid transforms are rotations R and translations t : the closed forms below
+			// assume that the 3x3 part of every Transform3D is orthonormal.
+
+			///////////////////
+			//-- Rodrigues --//
+			///////////////////
+
+			// Rotation vector Omega (unit axis times angle) and linear part V of a rigid
+			// motion : exp of the twist is the transform reached at unit time.
+			template<typename T>
+			struct Twist
+			{
+				T Omega[3];
+				T V[3];
+			};
+
+			static_assert(std::is_trivially_copyable<Twist<float>>::value, "Twist must remain trivially copyable.");
+
+			// A = sin(t) / t, B = (1 - cos(t)) / t^2, C = (t - sin(t)) / t^3 for t^2 = theta2,
+			// expanded near 0. B uses the half angle, which does not cancel for small t.
+			template<typename T>
+			void RodriguesCoefficients(T theta2, T& A, T& B, T& C)
+			{
+				using std::sin;
+				using std::sqrt;
+
+				if (theta2 < sqrt(std::numeric_limits<T>::epsilon()))
+				{
+					A = T(1) - theta2 / T(6);
+					B = T(0.5) - theta2 / T(24);
+					C = T(1) / T(6) - theta2 / T(120);
+					return;
+				}
+
+				T theta = sqrt(theta2);
+				T half  = sin(theta / T(2)) / (theta / T(2));
+
+				A = sin(theta) / theta;
+				B = half * half / T(2);
+				C = (T(1) - A) / theta2;
+			}
+
+			// R = I + A [w]x + B [w]x^2, with [w]x^2 = w w' - |w|^2 I
+			template<typename T>
+			void SetRotation(Transform3D<T>& result, const T(&w)[3], T A, T B)
+			{
+				const T x = w[0], y = w[1], z = w[2];
+				const T theta2 = x * x + y * y + z * z;
+
+				result.Rux = T(1) + B * (x * x - theta2);
+				result.Rvx = -A * z + B * x * y;
+				result.Rwx =  A * y + B * x * z;
+
+				result.Ruy =  A * z + B * x * y;
+				result.Rvy = T(1) + B * (y * y - theta2);
+				result.Rwy = -A * x + B * y * z;
+
+				result.Ruz = -A * y + B * x * z;
+				result.Rvz =  A * x + B * y * z;
+				result.Rwz = T(1) + B * (z * z - theta2);
+			}
+
+			template<typename T>
+			void Cross(const T(&a)[3], const T(&b)[3], T(&result)[3])
+			{
+				result[0] = a[1] * b[2] - a[2] * b[1];
+				result[1] = a[2] * b[0] - a[0] * b[2];
+				result[2] = a[0] * b[1] - a[1] * b[0];
+			}
+
+			//////////////
+			//-- SO 3 --//
+			//////////////
+
+			// Rotation of angle |omega| around omega, no translation
+			template<typename T>
+			Transform3D<T> ExpSO3(const T(&omega)[3])
+			{
+				T A, B, C;
+				RodriguesCoefficients(omega[0] * omega[0] + omega[1] * omega[1] + omega[2] * omega[2], A, B, C);
+
+				Transform3D<T> result;
+
+				SetRotation(result, omega, A, B);
+
+				return result;
+			}
+
+			// Rotation vector of the 3x3 part of t, of angle in [0, pi]. Near pi the axis is
+			// read from the symmetric part, the antisymmetric one vanishing there.
+			template<typename T>
+			void LogSO3(const Transform3D<T>& t, T(&omega)[3])
+			{
+				using std::sqrt;
+				using std::atan2;
+
+				T s[3] = { (t.Rvz - t.Rwy) / T(2), (t.Rwx - t.Ruz) / T(2), (t.Ruy - t.Rvx) / T(2) };
+
+				T c     = (t.Rux + t.Rvy + t.Rwz - T(1)) / T(2);
+				T sine  = sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+				T theta = atan2(sine, c);
+
+				if (c > T(0))
+				{
+					T factor = theta * theta < sqrt(std::numeric_limits<T>::epsilon()) ? T(1) + theta * theta / T(6) : theta / sine;
+
+					for (int k = 0; k < 3; ++k)
+						omega[k] = factor * s[k];
+
+					return;
+				}
+
+				// R = cos I + (1 - cos) n n' + sin [n]x
+				const T R[3][3] = {
+					{ t.Rux, t.Rvx, t.Rwx },
+					{ t.Ruy, t.Rvy, t.Rwy },
+					{ t.Ruz, t.Rvz, t.Rwz }
+				};
+
+				int i = 0;
+
+				if (R[1][1] > R[i][i]) i = 1;
+				if (R[2][2] > R[i][i]) i = 2;
+
+				T n[3];
+
+				n[i] = sqrt(std::max(R[i][i] - c, T(0)) / (T(1) - c));
+
+				for (int j = 0; j < 3; ++j)
+					if (j != i)
+						n[j] = (R[i][j] + R[j][i]) / (T(2) * (T(1) - c) * n[i]);
+
+				if (n[0] * s[0] + n[1] * s[1] + n[2] * s[2] < T(0))
+					theta = -theta;
+
+				for (int k = 0; k < 3; ++k)
+					omega[k] = theta * n[k];
+			}
+
+			//////////////
+			//-- SE 3 --//
+			//////////////
+
+			// R = exp(Omega), t = (I + B [w]x + C [w]x^2) V
+			template<typename T>
+			Transform3D<T> ExpSE3(const Twist<T>& twist)
+			{
+				const T(&w)[3] = twist.Omega;
+
+				T A, B, C;
+				RodriguesCoefficients(w[0] * w[0] + w[1] * w[1] + w[2] * w[2], A, B, C);
+
+				Transform3D<T> result;
+
+				SetRotation(result, w, A, B);
+
+				T wv[3], wwv[3];
+				Cross(w, twist.V, wv);
+				Cross(w, wv, wwv);
+
+				result.Tx = twist.V[0] + B * wv[0] + C * wwv[0];
+				result.Ty = twist.V[1] + B * wv[1] + C * wwv[1];
+				result.Tz = twist.V[2] + B * wv[2] + C * wwv[2];
+
+				return result;
+			}
+
+			// Inverse of ExpSE3 : V = (I - [w]x / 2 + D [w]x^2) t with D = (1 - A / 2B) / theta^2
+			template<typename T>
+			Twist<T> LogSE3(const Transform3D<T>& t)
+			{
+				using std::sin;
+				using std::cos;
+				using std::sqrt;
+
+				Twist<T> result;
+
+				LogSO3(t, result.Omega);
+
+				const T(&w)[3] = result.Omega;
+				const T theta2 = w[0] * w[0] + w[1] * w[1] + w[2] * w[2];
+
+				T D;
+
+				if (theta2 < sqrt(std::numeric_limits<T>::epsilon()))
+				{
+					D = T(1) / T(12) + theta2 / T(720);
+				}
+				else
+				{
+					T half = sqrt(theta2) / T(2);
+
+					D = (T(1) - half * cos(half) / sin(half)) / theta2;
+				}
+
+				const T u[3] = { t.Tx, t.Ty, t.Tz };
+
+				T wu[3], wwu[3];
+				Cross(w, u, wu);
+				Cross(w, wu, wwu);
+
+				for (int k = 0; k < 3; ++k)
+					result.V[k] = u[k] - wu[k] / T(2) + D * wwu[k];
+
+				return result;
+			}
+
+			///////////////////////
+			//-- Interpolation --//
+			///////////////////////
+
+			// R' and -R' t
+			template<typename T>
+			Transform3D<T> InvertRigid(const Transform3D<T>& t)
+			{
+				Transform3D<T> result;
+
+				result.Rux = t.Rux; result.Rvx = t.Ruy; result.Rwx = t.Ruz;
+				result.Ruy = t.Rvx; result.Rvy = t.Rvy; result.Rwy = t.Rvz;
+				result.Ruz = t.Rwx; result.Rvz = t.Rwy; result.Rwz = t.Rwz;
+
+				result.Tx = -(t.Rux * t.Tx + t.Ruy * t.Ty + t.Ruz * t.Tz);
+				result.Ty = -(t.Rvx * t.Tx + t.Rvy * t.Ty + t.Rvz * t.Tz);
+				result.Tz = -(t.Rwx * t.Tx + t.Rwy * t.Ty + t.Rwz * t.Tz);
+
+				return result;
+			}
+
+			// Screw motion from a (s = 0) to b (s = 1) at constant velocity : a exp(s log(a^-1 b))
+			template<typename T>
+			Transform3D<T> Interpolate(const Transform3D<T>& a, const Transform3D<T>& b, T s)
+			{
+				Transform3D<T> relative;
+				Compose(InvertRigid(a), b, relative);
+
+				Twist<T> twist = LogSE3(relative);
+
+				for (int k = 0; k < 3; ++k)
+				{
+					twist.Omega[k] *= s;
+					twist.V[k]     *= s;
+				}
+
+				Transform3D<T> result;
+				Compose(a, ExpSE3(twist), result);
+
+				return result;
+			}
+
+			///////////////////////////
+			//-- Batched operators --//
+			///////////////////////////
+
+			// result[i] = Interpolate(a[i], b[i], s), the poses of a skeleton between two keys
+			template<typename T>
+			void Interpolate(const Transform3D<T>* a, const Transform3D<T>* b, T s, Transform3D<T>* result, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = Interpolate(a[i], b[i], s);
+			}
+
+			// result[i] = Interpolate(a[i], b[i], s[i])
+			template<typename T>
+			void Interpolate(const Transform3D<T>* a, const Transform3D<T>* b, const T* s, Transform3D<T>* result, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					result[i] = Interpolate(a[i], b[i], s[i]);
+			}
+		}
+	}
+}
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "Transform3D.h"
+#include "../../Utilities/Async.h"
+
+namespace LCNMath {
+	namespace Geometry {
+		namespace Dim3 {
+
+			/////////////////////////////
+			//-- Transform hierarchy --//
+			/////////////////////////////
+
+			// Scene graph of Transform3D : World(node) = World(parent) * Local(node).
+			// Nodes are stored in flat arrays in breadth first order, so that every level is
+			// contiguous, every parent precedes its children and the descendants of a range
+			// of nodes form a range on each level below. Update only recomputes the subtrees
+			// under nodes whose local transform changed, one level after the other, as lists
+			// of ranges : its cost follows the number of stale nodes, not the size of the
+			// hierarchy. The ranges of a large level are split among the threads of a pool.
+			//
+			// Nodes are designated by the handle returned by Add, which does not change when
+			// the arrays are reordered.
+			template<typename T>
+			class TransformHierarchy
+			{
+			public:
+				static constexpr uint32_t None = UINT32_MAX;
+
+				// Levels with fewer nodes are updated on the calling thread
+				static constexpr size_t ParallelThreshold = 1 << 14;
+
+				TransformHierarchy() = default;
+
+				// Node i has parent parents[i], None for a root, in any order : handles are 0 .. count - 1
+				TransformHierarchy(const uint32_t* parents, const Transform3D<T>* locals, size_t count)
+				{
+					m_Parents.assign(parents, parents + count);
+					m_PendingLocal.assign(locals, locals + count);
+
+					this->Rebuild();
+				}
+
+				size_t Size() const { return m_Parents.size(); }
+
+				// The parent must already exist. The node is placed at the next Update.
+				uint32_t Add(uint32_t parent, const Transform3D<T>& local)
+				{
+					if (parent != None && parent >= m_Parents.size())
+						throw std::exception("Parent must be an existing node.");
+
+					m_Parents.push_back(parent);
+					m_PendingLocal.push_back(local);
+
+					return uint32_t(m_Parents.size() - 1);
+				}
+
+				uint32_t Parent(uint32_t node) const { return m_Parents[node]; }
+
+				const Transform3D<T>& Local(uint32_t node) const
+				{
+					return node < m_Index.size() ? m_Local[m_Index[node]] : m_PendingLocal[node - m_Index.size()];
+				}
+
+				// As of the last Update
+				const Transform3D<T>& World(uint32_t node) const
+				{
+					ASSERT(node < m_Index.size());
+
+					return m_World[m_Index[node]];
+				}
+
+				void SetLocal(uint32_t node, const Transform3D<T>& local)
+				{
+					if (node >= m_Index.size())
+					{
+						m_PendingLocal[node - m_Index.size()] = local;
+						return;
+					}
+
+					uint32_t i = m_Index[node];
+
+					m_Local[i] = local;
+
+					if (!m_Dirty[i])
+					{
+						m_Dirty[i] = 1;
+						m_DirtyList.push_back(i);
+					}
+				}
+
+				// Brings World up to date, placing the nodes added since the last call first.
+				// Slices of large levels that no pool thread has started are run by the calling
+				// thread, which may itself be a thread of pool.
+				void Update(Async::ThreadPool& pool = Async::ThreadPool::Shared())
+				{
+					if (!m_PendingLocal.empty())
+						this->Rebuild();
+
+					if (m_DirtyList.empty())
+						return;
+
+					// Breadth first order is level order
+					std::sort(m_DirtyList.begin(), m_DirtyList.end());
+
+					m_Ranges.clear();
+
+					size_t d = 0;
+
+					for (size_t l = this->LevelOf(m_DirtyList[0]); l < this->LevelCount(); ++l)
+					{
+						// Nothing stale on this level : go to the level of the next dirty node
+						if (m_Ranges.empty())
+						{
+							if (d == m_DirtyList.size())
+								break;
+
+							l = this->LevelOf(m_DirtyList[d]);
+						}
+
+						const uint32_t end = uint32_t(m_LevelStart[l + 1]);
+
+						// Children of the ranges updated on the level above, merged with the nodes set on this one
+						m_Next.clear();
+
+						size_t r = 0;
+
+						while (r < m_Ranges.size() || (d < m_DirtyList.size() && m_DirtyList[d] < end))
+						{
+							if (r < m_Ranges.size() && (d == m_DirtyList.size() || m_DirtyList[d] >= end || m_ChildStart[m_Ranges[r].First] <= m_DirtyList[d]))
+							{
+								this->Append(m_ChildStart[m_Ranges[r].First], m_ChildStart[m_Ranges[r].Last]);
+								r++;
+							}
+							else
+							{
+								m_Dirty[m_DirtyList[d]] = 0;
+
+								this->Append(m_DirtyList[d], m_DirtyList[d] + 1);
+								d++;
+							}
+						}
+
+						m_Ranges.swap(m_Next);
+
+						this->UpdateRanges(pool);
+					}
+
+					m_DirtyList.clear();
+				}
+
+				// Flat breadth first arrays, for batched consumers : the world transform of node
+				// is WorldData()[Index(node)], level l spans [LevelStart(l), LevelStart(l + 1)).
+				const Transform3D<T>* WorldData() const { return m_World.data(); }
+
+				uint32_t Index(uint32_t node)  const { return m_Index[node]; }
+				uint32_t Handle(uint32_t index) const { return m_Handle[index]; }
+
+				size_t LevelCount()          const { return m_LevelStart.empty() ? 0 : m_LevelStart.size() - 1; }
+				size_t LevelStart(size_t l)  const { return m_LevelStart[l]; }
+
+			private:
+				// Nodes [First, Last) in breadth first order
+				struct Range
+				{
+					uint32_t First;
+					uint32_t Last;
+				};
+
+				size_t LevelOf(uint32_t i) const
+				{
+					return size_t(std::upper_bound(m_LevelStart.begin(), m_LevelStart.end(), size_t(i)) - m_LevelStart.begin()) - 1;
+				}
+
+				// Adds [first, last) to m_Next, which is sorted, merging it with the last range
+				void Append(uint32_t first, uint32_t last)
+				{
+					if (first == last)
+						return;
+
+					if (!m_Next.empty() && first <= m_Next.back().Last)
+						m_Next.back().Last = std::max(m_Next.back().Last, last);
+					else
+						m_Next.push_back({ first, last });
+				}
+
+				// Every node of a range is stale : its parent was recomputed or it was set
+				void UpdateRange(size_t first, size_t last)
+				{
+					for (size_t i = first; i < last; ++i)
+					{
+						uint32_t p = m_Parent[i];
+
+						if (p == None)
+							m_World[i] = m_Local[i];
+						else
+							Compose(m_World[p], m_Local[i], m_World[i]);
+					}
+				}
+
+				// The ranges of m_Ranges, seen as one sequence of nodes when it is split among threads
+				void UpdateRanges(Async::ThreadPool& pool)
+				{
+					m_Offsets.resize(m_Ranges.size() + 1);
+					m_Offsets[0] = 0;
+
+					for (size_t r = 0; r < m_Ranges.size(); ++r)
+						m_Offsets[r + 1] = m_Offsets[r] + (m_Ranges[r].Last - m_Ranges[r].First);
+
+					const size_t total = m_Offsets.back();
+
+					if (total < ParallelThreshold || pool.Size() < 2)
+					{
+						for (const Range& range : m_Ranges)
+							this->UpdateRange(range.First, range.Last);
+
+						return;
+					}
+
+					Async::ParallelFor(pool, 0, total, [this](size_t b, size_t e)
+					{
+						size_t r = size_t(std::upper_bound(m_Offsets.begin(), m_Offsets.end(), b) - m_Offsets.begin()) - 1;
+
+						for (; b < e; ++r)
+						{
+							size_t first = m_Ranges[r].First + (b - m_Offsets[r]);
+							size_t last  = m_Ranges[r].First + (std::min(e, m_Offsets[r + 1]) - m_Offsets[r]);
+
+							this->UpdateRange(first, last);
+
+							b += last - first;
+						}
+					});
+				}
+
+				// Breadth first order from the roots, every node dirty
+				void Rebuild()
+				{
+					const size_t count = m_Parents.size();
+					const size_t known = m_Index.size();
+
+					// Children of each node, counting sort on the parent
+					std::vector<uint32_t> childstart(count + 3, 0);
+					std::vector<uint32_t> children(count);
+
+					for (size_t h = 0; h < count; ++h)
+					{
+						if (m_Parents[h] != None && m_Parents[h] >= count)
+							throw std::exception("Parent must be an existing node.");
+
+						childstart[(m_Parents[h] == None ? count : m_Parents[h]) + 2]++;
+					}
+
+					for (size_t k = 2; k < childstart.size(); ++k)
+						childstart[k] += childstart[k - 1];
+
+					for (size_t h = 0; h < count; ++h)
+						children[childstart[(m_Parents[h] == None ? count : m_Parents[h]) + 1]++] = uint32_t(h);
+
+					// The roots are the children of count
+					m_Handle.clear();
+					m_Handle.reserve(count);
+					m_ChildStart.resize(count + 1);
+					m_LevelStart.assign(1, 0);
+
+					m_Handle.insert(m_Handle.end(), children.begin() + childstart[count], children.begin() + childstart[count + 1]);
+
+					for (size_t first = 0; first < m_Handle.size(); )
+					{
+						size_t last = m_Handle.size();
+
+						m_LevelStart.push_back(last);
+
+						for (size_t i = first; i < last; ++i)
+						{
+							uint32_t h = m_Handle[i];
+
+							m_ChildStart[i] = uint32_t(m_Handle.size());
+							m_Handle.insert(m_Handle.end(), children.begin() + childstart[h], children.begin() + childstart[h + 1]);
+						}
+
+						first = last;
+					}
+
+					if (m_Handle.size() != count)
+						throw std::exception("Hierarchy contains a cycle.");
+
+					m_ChildStart[count] = uint32_t(count);
+
+					// Local transforms gathered in the new order before the index is overwritten
+					std::vector<Transform3D<T>> locals;
+					locals.reserve(count);
+
+					for (uint32_t h : m_Handle)
+						locals.push_back(h < known ? m_Local[m_Index[h]] : m_PendingLocal[h - known]);
+
+					m_Local.swap(locals);
+					m_PendingLocal.clear();
+
+					m_Index.resize(count);
+					m_Parent.resize(count);
+					m_World.resize(count);
+
+					for (size_t i = 0; i < count; ++i)
+						m_Index[m_Handle[i]] = uint32_t(i);
+
+					for (size_t i = 0; i < count; ++i)
+					{
+						uint32_t p = m_Parents[m_Handle[i]];
+
+						m_Parent[i] = p == None ? None : m_Index[p];
+					}
+
+					// Every root is set, which updates the whole hierarchy
+					m_Dirty.assign(count, 0);
+					m_DirtyList.clear();
+
+					const size_t roots = count ? m_LevelStart[1] : 0;
+
+					for (size_t i = 0; i < roots; ++i)
+					{
+						m_Dirty[i] = 1;
+						m_DirtyList.push_back(uint32_t(i));
+					}
+				}
+
+				// Indexed by handle
+				std::vector<uint32_t>       m_Parents;
+				std::vector<uint32_t>       m_Index;
+				std::vector<Transform3D<T>> m_PendingLocal;
+
+				// Indexed in breadth first order
+				std::vector<uint32_t>       m_Handle;
+				std::vector<uint32_t>       m_Parent;
+				std::vector<uint32_t>       m_ChildStart;  // Children of i : [m_ChildStart[i], m_ChildStart[i + 1])
+				std::vector<Transform3D<T>> m_Local;
+				std::vector<Transform3D<T>> m_World;
+				std::vector<uint8_t>        m_Dirty;
+				std::vector<uint32_t>       m_DirtyList;
+				std::vector<size_t>         m_LevelStart;
+
+				// Update
+				std::vector<Range>          m_Ranges;
+				std::vector<Range>          m_Next;
+				std::vector<size_t>         m_Offsets;
+			};
+		}
+	}
+}
@@ -5,18 +5,18 @@
 namespace LCNMath{
 	namespace Geometry{
 
-		template<uint N>
+		template<typename T, uint N>
 		struct HVectorND
 		{
 			union
 			{
 				struct
 				{
-					VectorND<N> vec;
-					float s;
+					VectorND<T, N> vec;
+					T s;
 				};
 
-				VectorND<N + 1> hvec;
+				VectorND<T, N + 1> hvec;
 			};
 
 			HVectorND() :
@@ -27,14 +27,14 @@ namespace LCNMath{
 				hvec(_hvec.hvec)
 			{}
 
-			HVectorND(const VectorND<N>& _vec, float _s) :
+			HVectorND(const VectorND<T, N>& _vec, T _s) :
 				vec(_vec),
 				s(_s)
 			{}
 		};
 
-		template<uint N>
-		inline std::ostream& operator<<(std::ostream& stream, const HVectorND<N>& vec)
+		template<typename T, uint N>
+		inline std::ostream& operator<<(std::ostream& stream, const HVectorND<T, N>& vec)
 		{
 			stream << vec.vec << '(' << vec.s << ')';
 
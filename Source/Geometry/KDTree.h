@@ -0,0 +1,535 @@
+#pragma once
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+
+#include "VectorND.h"
+#include "Geometry3D/HVector3D.h"
+#include "../Utilities/SIMD.h"
+#include "../Utilities/Async.h"
+
+namespace LCNMath {
+	namespace Geometry {
+
+		//////////////////
+		//-- K-d tree --//
+		//////////////////
+
+		// Squared distances from q to the count points of a leaf bucket, stored dimension after
+		// dimension (SoA) : coords[d * count + i] is coordinate d of point i.
+		template<uint N, typename T>
+		void BucketDistances(const T* coords, size_t count, const T* q, T* result)
+		{
+			std::fill(result, result + count, T(0));
+
+			for (uint d = 0; d < N; ++d)
+			{
+				const T* c  = coords + d * count;
+				const T  qd = q[d];
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					T diff = c[i] - qd;
+
+					result[i] += diff * diff;
+				}
+			}
+		}
+
+#ifdef LCN_SSE
+		template<uint N>
+		void BucketDistances(const float* coords, size_t count, const float* q, float* result)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 acc = _mm_setzero_ps();
+
+				for (uint d = 0; d < N; ++d)
+				{
+					__m128 diff = _mm_sub_ps(_mm_loadu_ps(coords + d * count + i), _mm_set1_ps(q[d]));
+
+					acc = _mm_add_ps(acc, _mm_mul_ps(diff, diff));
+				}
+
+				_mm_storeu_ps(result + i, acc);
+			}
+
+			for (; i < count; ++i)
+			{
+				float sum = 0.0f;
+
+				for (uint d = 0; d < N; ++d)
+				{
+					float diff = coords[d * count + i] - q[d];
+
+					sum += diff * diff;
+				}
+
+				result[i] = sum;
+			}
+		}
+#endif
+
+		// Static k-d tree over points of dimension N. The whole index lives in one buffer
+		// laid out exactly like its file : Save() writes it as is, and View() searches a
+		// file mapped in memory by the caller (mmap, MapViewOfFile) without parsing it.
+		// The file uses the byte order of the machine that built it.
+		template<typename T, uint N>
+		class KDTree
+		{
+		public:
+			static constexpr size_t BucketSize = 16;
+
+			// Subtrees with more points than this are built in parallel, on the shared pool,
+			// down to about twice as many subtrees as the pool has threads
+			static constexpr size_t ParallelThreshold = 1 << 16;
+
+			struct Node
+			{
+				T        Split;
+				uint32_t Axis;   // N for a leaf
+				uint32_t Right;  // Internal node : index of the right child, the left one is next
+				uint32_t First;  // Leaf : first point of the bucket in Indices()
+				uint32_t Count;  // Leaf : number of points of the bucket
+			};
+
+			struct Neighbour
+			{
+				uint32_t Index;     // In the point array given at construction
+				T        Distance;  // Squared euclidean distance
+			};
+
+			struct Header
+			{
+				char     Magic[8];
+				uint32_t Dimension;
+				uint32_t ScalarSize;
+				uint64_t Points;
+				uint64_t Nodes;
+				uint64_t NodesOffset;
+				uint64_t IndicesOffset;
+				uint64_t CoordinatesOffset;
+				uint64_t Size;
+			};
+
+			KDTree() = default;
+
+			// coordinates holds count points of N coordinates each
+			KDTree(const T* coordinates, size_t count, bool parallel = true)
+			{
+				this->Build(coordinates, count, parallel);
+			}
+
+			KDTree(const VectorND<T, N>* points, size_t count, bool parallel = true)
+			{
+				std::vector<T> coordinates(count * N);
+
+				for (size_t i = 0; i < count; ++i)
+					for (uint d = 0; d < N; ++d)
+						coordinates[i * N + d] = points[i][d];
+
+				this->Build(coordinates.data(), count, parallel);
+			}
+
+			KDTree(const KDTree&)            = delete;
+			KDTree& operator=(const KDTree&) = delete;
+
+			KDTree(KDTree&&)            = default;
+			KDTree& operator=(KDTree&&) = default;
+
+			size_t Size() const { return m_Header ? size_t(m_Header->Points) : 0; }
+
+			const Node*     Nodes()   const { return m_Nodes; }
+			const uint32_t* Indices() const { return m_Indices; }
+
+			#pragma region Queries
+			// The k nearest points of q, closest first
+			std::vector<Neighbour> Nearest(const T* q, size_t k) const
+			{
+				std::vector<Neighbour> heap;
+
+				heap.reserve(k + 1);
+
+				this->Nearest(q, k, heap);
+
+				return heap;
+			}
+
+			// Same, in a buffer reused from one query to the next
+			void Nearest(const T* q, size_t k, std::vector<Neighbour>& result) const
+			{
+				result.clear();
+
+				if (k > 0 && this->Size() > 0)
+					this->SearchNearest(0, q, k, result);
+
+				std::sort_heap(result.begin(), result.end(), CloserFirst);
+			}
+
+			// Every point within radius of q, in no particular order
+			std::vector<Neighbour> Radius(const T* q, T radius) const
+			{
+				std::vector<Neighbour> result;
+
+				if (this->Size() > 0)
+					this->SearchRadius(0, q, radius * radius, result);
+
+				return result;
+			}
+
+			// Batched k-NN, split in slices among threads of pool (all of them by default) and the
+			// calling thread : indices and distances receive count lines of k results, padded
+			// with index UINT32_MAX if the tree has less than k points.
+			void Nearest(const T* queries, size_t count, size_t k, uint32_t* indices, T* distances, size_t threads = 0,
+				Async::ThreadPool& pool = Async::ThreadPool::Shared()) const
+			{
+				Async::ParallelFor(pool, 0, count, [this, queries, k, indices, distances](size_t first, size_t last)
+				{
+					// One candidate heap per slice
+					std::vector<Neighbour> result;
+
+					result.reserve(k + 1);
+
+					for (size_t i = first; i < last; ++i)
+					{
+						this->Nearest(queries + i * N, k, result);
+
+						for (size_t j = 0; j < k; ++j)
+						{
+							indices[i * k + j]   = j < result.size() ? result[j].Index : std::numeric_limits<uint32_t>::max();
+							distances[i * k + j] = j < result.size() ? result[j].Distance : std::numeric_limits<T>::infinity();
+						}
+					}
+				}, threads);
+			}
+			#pragma endregion
+
+			#pragma region Serialization
+			void Save(const std::string& path) const
+			{
+				std::ofstream file(path, std::ios::binary);
+
+				if (!file)
+					throw std::exception("Cannot open the k-d tree file.");
+
+				file.write(reinterpret_cast<const char*>(m_Buffer.data()), m_Buffer.size());
+			}
+
+			// Copies the file in memory
+			static KDTree Load(const std::string& path)
+			{
+				std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+				if (!file)
+					throw std::exception("Cannot open the k-d tree file.");
+
+				KDTree result;
+
+				result.m_Buffer.resize(size_t(file.tellg()));
+
+				file.seekg(0);
+				file.read(reinterpret_cast<char*>(result.m_Buffer.data()), result.m_Buffer.size());
+
+				result.Attach(result.m_Buffer.data(), result.m_Buffer.size());
+
+				return result;
+			}
+
+			// Searches a saved tree in place, data must outlive the view and be 64 bytes aligned
+			static KDTree View(const void* data, size_t size)
+			{
+				KDTree result;
+
+				result.Attach(static_cast<const unsigned char*>(data), size);
+
+				return result;
+			}
+			#pragma endregion
+
+		private:
+			static constexpr size_t Alignment = 64;
+
+			static size_t Align(size_t offset) { return (offset + Alignment - 1) & ~(Alignment - 1); }
+
+			static bool CloserFirst(const Neighbour& a, const Neighbour& b) { return a.Distance < b.Distance; }
+
+			#pragma region Construction
+			void Build(const T* coordinates, size_t count, bool parallel)
+			{
+				std::vector<uint32_t> indices(count);
+				std::iota(indices.begin(), indices.end(), uint32_t(0));
+
+				const size_t nodecount = count ? NodeCount(count) : 0;
+
+				Header header = {};
+
+				std::memcpy(header.Magic, "LCNKDT1", 8);
+
+				header.Dimension         = N;
+				header.ScalarSize        = sizeof(T);
+				header.Points            = count;
+				header.Nodes             = nodecount;
+				header.NodesOffset       = Align(sizeof(Header));
+				header.IndicesOffset     = Align(header.NodesOffset + nodecount * sizeof(Node));
+				header.CoordinatesOffset = Align(header.IndicesOffset + count * sizeof(uint32_t));
+				header.Size              = header.CoordinatesOffset + count * N * sizeof(T);
+
+				m_Buffer.assign(size_t(header.Size), 0);
+
+				unsigned char* buffer = m_Buffer.data();
+
+				std::memcpy(buffer, &header, sizeof(Header));
+
+				// The nodes are written in place, every subtree at the offset given by its size
+				Node* nodes = reinterpret_cast<Node*>(buffer + header.NodesOffset);
+
+				size_t depth   = 0;
+				size_t threads = Async::ThreadPool::Shared().Size();
+
+				if (parallel && threads > 1)
+					while ((size_t(1) << depth) < 2 * threads)
+						depth++;
+
+				if (count)
+					this->BuildRange(coordinates, indices, 0, count, nodes, 0, depth);
+
+				std::memcpy(buffer + header.IndicesOffset, indices.data(), count * sizeof(uint32_t));
+
+				// Buckets in SoA, in the order of the leaves
+				T* coords = reinterpret_cast<T*>(buffer + header.CoordinatesOffset);
+
+				for (size_t n = 0; n < nodecount; ++n)
+				{
+					const Node& node = nodes[n];
+
+					if (node.Axis == N)
+						for (uint d = 0; d < N; ++d)
+							for (size_t i = 0; i < node.Count; ++i)
+								coords[node.First * N + d * node.Count + i] = coordinates[size_t(indices[node.First + i]) * N + d];
+				}
+
+				this->Attach(buffer, m_Buffer.size());
+			}
+
+			// Nodes of a subtree over count points : the median split only depends on count
+			static size_t NodeCount(size_t count)
+			{
+				return count <= BucketSize ? 1 : 1 + NodeCount(count / 2) + NodeCount(count - count / 2);
+			}
+
+			// Subtree over indices[first, last) written from nodes[offset]
+			void BuildRange(const T* coordinates, std::vector<uint32_t>& indices, size_t first, size_t last, Node* nodes, size_t offset, size_t depth)
+			{
+				Node& node = nodes[offset];
+
+				node = {};
+
+				if (last - first <= BucketSize)
+				{
+					node.Axis  = N;
+					node.First = uint32_t(first);
+					node.Count = uint32_t(last - first);
+
+					return;
+				}
+
+				// Split the dimension of largest spread at the median
+				T spread = T(-1);
+
+				for (uint d = 0; d < N; ++d)
+				{
+					T lo = std::numeric_limits<T>::max(), hi = std::numeric_limits<T>::lowest();
+
+					for (size_t p = first; p < last; ++p)
+					{
+						lo = std::min(lo, coordinates[size_t(indices[p]) * N + d]);
+						hi = std::max(hi, coordinates[size_t(indices[p]) * N + d]);
+					}
+
+					if (hi - lo > spread)
+					{
+						spread    = hi - lo;
+						node.Axis = d;
+					}
+				}
+
+				size_t middle = (first + last) / 2;
+				uint   axis   = node.Axis;
+
+				std::nth_element(indices.begin() + first, indices.begin() + middle, indices.begin() + last,
+					[coordinates, axis](uint32_t a, uint32_t b) { return coordinates[size_t(a) * N + axis] < coordinates[size_t(b) * N + axis]; });
+
+				node.Split = coordinates[size_t(indices[middle]) * N + axis];
+				node.Right = uint32_t(offset + 1 + NodeCount(middle - first));
+
+				const size_t right = node.Right;
+
+				// The two halves work on disjoint ranges of indices and nodes
+				if (depth > 0 && last - first > ParallelThreshold)
+				{
+					Async::Invoke(Async::ThreadPool::Shared(),
+						[this, coordinates, &indices, first, middle, nodes, offset, depth] { this->BuildRange(coordinates, indices, first, middle, nodes, offset + 1, depth - 1); },
+						[this, coordinates, &indices, middle, last, nodes, right, depth]   { this->BuildRange(coordinates, indices, middle, last, nodes, right, depth - 1); });
+				}
+				else
+				{
+					this->BuildRange(coordinates, indices, first, middle, nodes, offset + 1, 0);
+					this->BuildRange(coordinates, indices, middle, last, nodes, right, 0);
+				}
+			}
+
+			void Attach(const unsigned char* data, size_t size)
+			{
+				const Header* header = reinterpret_cast<const Header*>(data);
+
+				if (size < sizeof(Header) || std::memcmp(header->Magic, "LCNKDT1", 8) != 0 || header->Size > size)
+					throw std::exception("Invalid k-d tree data.");
+
+				if (header->Dimension != N || header->ScalarSize != sizeof(T))
+					throw std::exception("The k-d tree data does not match this tree type.");
+
+				// Sections in order, inside the data, aligned for their type
+				const uint64_t points = header->Points;
+				const uint64_t nodes  = header->Nodes;
+
+				if (points >= std::numeric_limits<uint32_t>::max() || nodes >= std::numeric_limits<uint32_t>::max() || (points > 0) != (nodes > 0) ||
+					!Section<Node>(data, sizeof(Header), header->NodesOffset, nodes, header->IndicesOffset) ||
+					!Section<uint32_t>(data, header->NodesOffset, header->IndicesOffset, points, header->CoordinatesOffset) ||
+					!Section<T>(data, header->IndicesOffset, header->CoordinatesOffset, points * N, header->Size))
+					throw std::exception("Invalid k-d tree data.");
+
+				const Node*     tree    = reinterpret_cast<const Node*>(data + header->NodesOffset);
+				const uint32_t* indices = reinterpret_cast<const uint32_t*>(data + header->IndicesOffset);
+
+				// Searches only move forward in the node array and read the buckets in bounds
+				for (uint64_t n = 0; n < nodes; ++n)
+				{
+					const Node& node = tree[n];
+
+					bool valid = node.Axis == N ?
+						(node.Count <= BucketSize && node.First <= points && node.Count <= points - node.First) :
+						(node.Axis < N && n + 1 < nodes && node.Right > n + 1 && node.Right < nodes);
+
+					if (!valid)
+						throw std::exception("Invalid k-d tree data.");
+				}
+
+				for (uint64_t i = 0; i < points; ++i)
+					if (indices[i] >= points)
+						throw std::exception("Invalid k-d tree data.");
+
+				m_Header      = header;
+				m_Nodes       = tree;
+				m_Indices     = indices;
+				m_Coordinates = reinterpret_cast<const T*>(data + header->CoordinatesOffset);
+			}
+
+			// count elements of type E from offset, after the previous section and before end
+			template<typename E>
+			static bool Section(const unsigned char* data, uint64_t previous, uint64_t offset, uint64_t count, uint64_t end)
+			{
+				return offset >= previous && offset <= end && count <= (end - offset) / sizeof(E) &&
+					reinterpret_cast<uintptr_t>(data + offset) % alignof(E) == 0;
+			}
+			#pragma endregion
+
+			#pragma region Search
+			void SearchNearest(size_t n, const T* q, size_t k, std::vector<Neighbour>& heap) const
+			{
+				const Node& node = m_Nodes[n];
+
+				if (node.Axis == N)
+				{
+					T distances[BucketSize];
+
+					BucketDistances<N>(m_Coordinates + size_t(node.First) * N, node.Count, q, distances);
+
+					for (uint32_t i = 0; i < node.Count; ++i)
+					{
+						if (heap.size() == k && !(distances[i] < heap.front().Distance))
+							continue;
+
+						heap.push_back({ m_Indices[node.First + i], distances[i] });
+						std::push_heap(heap.begin(), heap.end(), CloserFirst);
+
+						if (heap.size() > k)
+						{
+							std::pop_heap(heap.begin(), heap.end(), CloserFirst);
+							heap.pop_back();
+						}
+					}
+
+					return;
+				}
+
+				T diff = q[node.Axis] - node.Split;
+
+				size_t nearchild = diff < T(0) ? n + 1 : node.Right;
+				size_t farchild  = diff < T(0) ? node.Right : n + 1;
+
+				this->SearchNearest(nearchild, q, k, heap);
+
+				// The far side can only help if the splitting plane is closer than the worst candidate
+				if (heap.size() < k || diff * diff < heap.front().Distance)
+					this->SearchNearest(farchild, q, k, heap);
+			}
+
+			void SearchRadius(size_t n, const T* q, T radius2, std::vector<Neighbour>& result) const
+			{
+				const Node& node = m_Nodes[n];
+
+				if (node.Axis == N)
+				{
+					T distances[BucketSize];
+
+					BucketDistances<N>(m_Coordinates + size_t(node.First) * N, node.Count, q, distances);
+
+					for (uint32_t i = 0; i < node.Count; ++i)
+						if (distances[i] <= radius2)
+							result.push_back({ m_Indices[node.First + i], distances[i] });
+
+					return;
+				}
+
+				T diff = q[node.Axis] - node.Split;
+
+				if (diff < T(0) || diff * diff <= radius2)
+					this->SearchRadius(n + 1, q, radius2, result);
+
+				if (diff >= T(0) || diff * diff <= radius2)
+					this->SearchRadius(node.Right, q, radius2, result);
+			}
+			#pragma endregion
+
+			std::vector<unsigned char> m_Buffer;  // Empty for a view
+
+			const Header*   m_Header      = nullptr;
+			const Node*     m_Nodes       = nullptr;
+			const uint32_t* m_Indices     = nullptr;
+			const T*        m_Coordinates = nullptr;
+		};
+
+		// k-d tree over the (x, y, z) of homogeneous points
+		inline KDTree<float, 3> MakeKDTree(const Dim3::HVector3D<float>* points, size_t count, bool parallel = true)
+		{
+			std::vector<float> coordinates(count * 3);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				coordinates[3 * i]     = points[i].x;
+				coordinates[3 * i + 1] = points[i].y;
+				coordinates[3 * i + 2] = points[i].z;
+			}
+
+			return KDTree<float, 3>(coordinates.data(), count, parallel);
+		}
+	}
+}
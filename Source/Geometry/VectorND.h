@@ -5,6 +5,7 @@
 #include <initializer_list>
 
 #include "../Matrix/Stack/SMatrix.h"
+#include "../Utilities/SIMD.h"
 
 namespace LCNMath{
 	namespace Geometry	{
@@ -17,16 +18,16 @@ namespace LCNMath{
 		{
 		public:
 			VectorND() :
-				MatrixN1<T, N>(1.0f)
+				MatrixN1<T, N>(T(1))
 			{}
 			
 			VectorND(uint i) :
-				MatrixN1<T, N>(0.0f)
+				MatrixN1<T, N>(T(0))
 			{
-				(*this)[i] = 1.0f;
+				(*this)[i] = T(1);
 			}
 
-			VectorND(const std::initializer_list<float>& _paramlist) :
+			VectorND(const std::initializer_list<T>& _paramlist) :
 				MatrixN1<T, N>(_paramlist)
 			{}
 
@@ -36,12 +37,9 @@ namespace LCNMath{
 
 			T Norm() const
 			{
-				T norm = 0.0f;
+				using std::sqrt;
 
-				for (uint i = 0; i < N; i++)
-					norm += (*this)(i, 0) * (*this)(i, 0);
-
-				return std::sqrt(norm);
+				return T(sqrt(LCNMath::SIMD::DotProduct(this->Data(), this->Data(), N)));
 			}
 
 			inline T& operator[](uint i)
@@ -62,18 +60,15 @@ namespace LCNMath{
 			}
 		};
 
+		static_assert(std::is_trivially_copyable<VectorND<float, 4>>::value, "VectorND must remain trivially copyable.");
+
 		////////////////////////////
 		//-- External Operators --//
 		////////////////////////////
 		template<typename T, uint N>
 		T operator|(const VectorND<T, N>& vec1, const VectorND<T, N>& vec2)
 		{
-			float dotproduct = 0.0f;
-		
-			for (uint i = 0; i < N; i++)
-				dotproduct += vec1(i, 0) * vec2(i, 0);
-		
-			return dotproduct;
+			return T(LCNMath::SIMD::DotProduct(vec1.Data(), vec2.Data(), N));
 		}
 
 		template<typename T, uint N>
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cmath>
+
+#include "VectorND.h"
+#include "../Utilities/SIMD.h"
+
+namespace LCNMath {
+	namespace Geometry {
+
+		///////////////////////////
+		//-- Batched operators --//
+		///////////////////////////
+
+		// result[i] = length of v[i]. Fast precision only changes the float kernels.
+		template<typename T, uint N>
+		void Length(const VectorND<T, N>* v, T* result, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+		{
+			for (size_t i = 0; i < count; ++i)
+				result[i] = std::sqrt(SIMD::DotProduct(v[i].Data(), v[i].Data(), N));
+		}
+
+		// result[i] = v[i] / length, null vectors stay null. result may alias v.
+		template<typename T, uint N>
+		void Normalize(const VectorND<T, N>* v, VectorND<T, N>* result, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				T inv = SIMD::SafeInverseSqrt(SIMD::DotProduct(v[i].Data(), v[i].Data(), N));
+
+				for (uint d = 0; d < N; ++d)
+					result[i][d] = v[i][d] * inv;
+			}
+		}
+
+		/////////////////////
+		//-- SoA batches --//
+		/////////////////////
+
+		// Coordinate d of vector i is components[d][i]
+		template<typename T, uint N>
+		void Length(const T* const (&components)[N], T* result, size_t count, SIMD::Precision = SIMD::Precision::Exact)
+		{
+			std::fill(result, result + count, T(0));
+
+			for (uint d = 0; d < N; ++d)
+				for (size_t i = 0; i < count; ++i)
+					result[i] += components[d][i] * components[d][i];
+
+			for (size_t i = 0; i < count; ++i)
+				result[i] = std::sqrt(result[i]);
+		}
+
+		// In place, null vectors stay null
+		template<typename T, uint N>
+		void Normalize(T* const (&components)[N], size_t count, SIMD::Precision = SIMD::Precision::Exact)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				T squared(0);
+
+				for (uint d = 0; d < N; ++d)
+					squared += components[d][i] * components[d][i];
+
+				T inv = SIMD::SafeInverseSqrt(squared);
+
+				for (uint d = 0; d < N; ++d)
+					components[d][i] *= inv;
+			}
+		}
+
+#ifdef LCN_SSE
+		// The squared lengths of 4 vectors share one reciprocal square root
+		template<uint N>
+		void Normalize(const VectorND<float, N>* v, VectorND<float, N>* result, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+		{
+			alignas(16) float inv[4];
+
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 squared = _mm_setr_ps(
+					SIMD::DotProduct(v[i].Data(),     v[i].Data(),     N),
+					SIMD::DotProduct(v[i + 1].Data(), v[i + 1].Data(), N),
+					SIMD::DotProduct(v[i + 2].Data(), v[i + 2].Data(), N),
+					SIMD::DotProduct(v[i + 3].Data(), v[i + 3].Data(), N));
+
+				_mm_store_ps(inv, SIMD::SafeInverseSqrt(squared, precision));
+
+				for (size_t k = 0; k < 4; ++k)
+					for (uint d = 0; d < N; ++d)
+						result[i + k][d] = v[i + k][d] * inv[k];
+			}
+
+			for (; i < count; ++i)
+			{
+				float scale = _mm_cvtss_f32(SIMD::SafeInverseSqrt(_mm_set_ss(SIMD::DotProduct(v[i].Data(), v[i].Data(), N)), precision));
+
+				for (uint d = 0; d < N; ++d)
+					result[i][d] = v[i][d] * scale;
+			}
+		}
+
+		template<uint N>
+		void Length(const VectorND<float, N>* v, float* result, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 squared = _mm_setr_ps(
+					SIMD::DotProduct(v[i].Data(),     v[i].Data(),     N),
+					SIMD::DotProduct(v[i + 1].Data(), v[i + 1].Data(), N),
+					SIMD::DotProduct(v[i + 2].Data(), v[i + 2].Data(), N),
+					SIMD::DotProduct(v[i + 3].Data(), v[i + 3].Data(), N));
+
+				_mm_storeu_ps(result + i, SIMD::Sqrt(squared, precision));
+			}
+
+			for (; i < count; ++i)
+				result[i] = _mm_cvtss_f32(SIMD::Sqrt(_mm_set_ss(SIMD::DotProduct(v[i].Data(), v[i].Data(), N)), precision));
+		}
+
+		// 4 vectors per register, one coordinate array after the other
+		template<uint N>
+		void Length(const float* const (&components)[N], float* result, size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 squared = _mm_setzero_ps();
+
+				for (uint d = 0; d < N; ++d)
+				{
+					__m128 c = _mm_loadu_ps(components[d] + i);
+
+					squared = _mm_add_ps(squared, _mm_mul_ps(c, c));
+				}
+
+				_mm_storeu_ps(result + i, SIMD::Sqrt(squared, precision));
+			}
+
+			for (; i < count; ++i)
+			{
+				float squared = 0.0f;
+
+				for (uint d = 0; d < N; ++d)
+					squared += components[d][i] * components[d][i];
+
+				result[i] = _mm_cvtss_f32(SIMD::Sqrt(_mm_set_ss(squared), precision));
+			}
+		}
+
+		template<uint N>
+		void Normalize(float* const (&components)[N], size_t count, SIMD::Precision precision = SIMD::Precision::Exact)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 squared = _mm_setzero_ps();
+
+				for (uint d = 0; d < N; ++d)
+				{
+					__m128 c = _mm_loadu_ps(components[d] + i);
+
+					squared = _mm_add_ps(squared, _mm_mul_ps(c, c));
+				}
+
+				__m128 inv = SIMD::SafeInverseSqrt(squared, precision);
+
+				for (uint d = 0; d < N; ++d)
+					_mm_storeu_ps(components[d] + i, _mm_mul_ps(_mm_loadu_ps(components[d] + i), inv));
+			}
+
+			for (; i < count; ++i)
+			{
+				float squared = 0.0f;
+
+				for (uint d = 0; d < N; ++d)
+					squared += components[d][i] * components[d][i];
+
+				float inv = _mm_cvtss_f32(SIMD::SafeInverseSqrt(_mm_set_ss(squared), precision));
+
+				for (uint d = 0; d < N; ++d)
+					components[d][i] *= inv;
+			}
+		}
+#endif
+	}
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "HMatrix.h"
+
+namespace LCNMath
+{
+	/////////////////////
+	//-- Band matrix --//
+	/////////////////////
+
+	// Square matrix whose coefficients are null outside the band i - Lower <= j <= i + Upper.
+	// Each line stores its Lower + Upper + 1 band coefficients : N (Lower + Upper + 1) in all.
+	template<typename T>
+	class HBandMatrix : public MatrixExpression<HBandMatrix<T>, T>
+	{
+	public:
+		using ValType = T;
+		using PtrType = T*;
+		using RefType = T&;
+
+	private:
+		size_t         m_Size;
+		size_t         m_Lower;
+		size_t         m_Upper;
+		std::vector<T> m_Band;
+
+	public:
+		HBandMatrix(size_t N, size_t lower, size_t upper) :
+			m_Size(N),
+			m_Lower(lower),
+			m_Upper(upper),
+			m_Band(N * (lower + upper + 1), T(0))
+		{}
+
+		// Coefficients of the expression outside the band are dropped
+		template<class E>
+		HBandMatrix(const MatrixExpression<E, ValType>& other, size_t lower, size_t upper) :
+			HBandMatrix(other.Line(), lower, upper)
+		{
+			ASSERT(other.Line() == other.Column());
+
+			for (size_t i = 0; i < m_Size; ++i)
+				for (size_t j = this->First(i); j < this->Last(i); ++j)
+					(*this)(i, j) = other(i, j);
+		}
+
+		size_t Line()   const { return m_Size; }
+		size_t Column() const { return m_Size; }
+
+		size_t LowerBandwidth() const { return m_Lower; }
+		size_t UpperBandwidth() const { return m_Upper; }
+
+		// Band coefficients of line i are in columns [First(i), Last(i))
+		size_t First(size_t i) const { return i > m_Lower ? i - m_Lower : 0; }
+		size_t Last(size_t i)  const { return std::min(m_Size, i + m_Upper + 1); }
+
+		bool InBand(size_t i, size_t j) const { return j + m_Lower >= i && j <= i + m_Upper; }
+
+		// Only coefficients inside the band can be written
+		RefType operator()(size_t i, size_t j)
+		{
+			ASSERT(this->InBand(i, j));
+
+			return m_Band[this->Index(i, j)];
+		}
+
+		ValType operator()(size_t i, size_t j) const
+		{
+			return this->InBand(i, j) ? m_Band[this->Index(i, j)] : T(0);
+		}
+
+		// Line i starts at Data() + i * (Lower + Upper + 1) with column i - Lower
+		PtrType Data() { return m_Band.data(); }
+		const T* Data() const { return m_Band.data(); }
+
+	private:
+		size_t Index(size_t i, size_t j) const { return i * (m_Lower + m_Upper + 1) + (j + m_Lower - i); }
+	};
+
+	//////////////////////
+	//-- Band kernels --//
+	//////////////////////
+
+	// Y = A X, N (Lower + Upper + 1) R operations (GBMV for one column)
+	template<typename T>
+	void BandProduct(const HBandMatrix<T>& A, const T* X, size_t ldx, T* Y, size_t ldy, size_t R)
+	{
+		const size_t width = A.LowerBandwidth() + A.UpperBandwidth() + 1;
+
+		for (size_t i = 0; i < A.Line(); ++i)
+		{
+			const T* line = A.Data() + i * width;
+
+			std::fill(Y + i * ldy, Y + i * ldy + R, T(0));
+
+			for (size_t j = A.First(i); j < A.Last(i); ++j)
+			{
+				T a = line[j + A.LowerBandwidth() - i];
+
+				for (size_t r = 0; r < R; ++r)
+					Y[i * ldy + r] += a * X[j * ldx + r];
+			}
+		}
+	}
+
+	// Picked by expression assignment for A * B
+	template<typename T>
+	void EvaluateProduct(HMatrix<T>& out, const HBandMatrix<T>& a, const HMatrix<T>& b)
+	{
+		ASSERT(a.Column() == b.Line());
+
+		BandProduct(a, b.Data(), b.Column(), out.Data(), out.Column(), b.Column());
+	}
+
+	/////////////////
+	//-- Band LU --//
+	/////////////////
+
+	// P A = L U with partial pivoting in O(N Lower (Lower + Upper)). Line swaps widen
+	// the upper band of U to Lower + Upper, which is stored from the start.
+	template<typename T>
+	class BandLU
+	{
+	private:
+		size_t              m_Size;
+		size_t              m_Lower;
+		size_t              m_Upper;  // Of U
+		std::vector<T>      m_LU;
+		std::vector<size_t> m_Pivots;
+
+		size_t Width() const { return m_Lower + m_Upper + 1; }
+
+		T& At(size_t i, size_t j) { return m_LU[i * this->Width() + (j + m_Lower - i)]; }
+		T  At(size_t i, size_t j) const { return m_LU[i * this->Width() + (j + m_Lower - i)]; }
+
+	public:
+		// Throws if a null pivot is met
+		explicit BandLU(const HBandMatrix<T>& A) :
+			m_Size(A.Line()),
+			m_Lower(A.LowerBandwidth()),
+			m_Upper(A.LowerBandwidth() + A.UpperBandwidth()),
+			m_LU(A.Line() * (2 * A.LowerBandwidth() + A.UpperBandwidth() + 1), T(0)),
+			m_Pivots(A.Line())
+		{
+			using std::abs;
+
+			const size_t N = m_Size;
+
+			for (size_t i = 0; i < N; ++i)
+				for (size_t j = A.First(i); j < A.Last(i); ++j)
+					this->At(i, j) = A(i, j);
+
+			for (size_t k = 0; k < N; ++k)
+			{
+				const size_t lines   = std::min(N, k + m_Lower + 1);
+				const size_t columns = std::min(N, k + m_Upper + 1);
+
+				size_t p = k;
+
+				for (size_t i = k + 1; i < lines; ++i)
+					if (abs(this->At(i, k)) > abs(this->At(p, k)))
+						p = i;
+
+				if (this->At(p, k) == T(0))
+					throw std::exception("This matrix is singular.");
+
+				m_Pivots[k] = p;
+
+				if (p != k)
+					for (size_t j = k; j < columns; ++j)
+						std::swap(this->At(p, j), this->At(k, j));
+
+				T inv = T(1) / this->At(k, k);
+
+				for (size_t i = k + 1; i < lines; ++i)
+				{
+					T factor = (this->At(i, k) *= inv);
+
+					for (size_t j = k + 1; j < columns; ++j)
+						this->At(i, j) -= factor * this->At(k, j);
+				}
+			}
+		}
+
+		// X such that A X = B
+		HMatrix<T> Solve(HMatrix<T> B) const
+		{
+			ASSERT(B.Line() == m_Size);
+
+			const size_t N = m_Size;
+			const size_t R = B.Column();
+
+			T* b = B.Data();
+
+			for (size_t k = 0; k < N; ++k)
+			{
+				if (m_Pivots[k] != k)
+					std::swap_ranges(b + k * R, b + (k + 1) * R, b + m_Pivots[k] * R);
+
+				for (size_t i = k + 1; i < std::min(N, k + m_Lower + 1); ++i)
+				{
+					T factor = this->At(i, k);
+
+					for (size_t r = 0; r < R; ++r)
+						b[i * R + r] -= factor * b[k * R + r];
+				}
+			}
+
+			for (size_t k = N; k-- > 0;)
+			{
+				for (size_t j = k + 1; j < std::min(N, k + m_Upper + 1); ++j)
+				{
+					T factor = this->At(k, j);
+
+					for (size_t r = 0; r < R; ++r)
+						b[k * R + r] -= factor * b[j * R + r];
+				}
+
+				T inv = T(1) / this->At(k, k);
+
+				for (size_t r = 0; r < R; ++r)
+					b[k * R + r] *= inv;
+			}
+
+			return B;
+		}
+	};
+
+	///////////////////////
+	//-- Band Cholesky --//
+	///////////////////////
+
+	// A = L L^T for a symmetric positive definite band matrix, in O(N Lower^2).
+	// Only the lower band of A is read, L has the same bandwidth.
+	template<typename T>
+	class BandCholesky
+	{
+	private:
+		size_t         m_Size;
+		size_t         m_Band;
+		std::vector<T> m_L;
+
+		T& At(size_t i, size_t j) { return m_L[i * (m_Band + 1) + (j + m_Band - i)]; }
+		T  At(size_t i, size_t j) const { return m_L[i * (m_Band + 1) + (j + m_Band - i)]; }
+
+		size_t First(size_t i) const { return i > m_Band ? i - m_Band : 0; }
+
+	public:
+		// Throws if A is not positive definite
+		explicit BandCholesky(const HBandMatrix<T>& A) :
+			m_Size(A.Line()),
+			m_Band(A.LowerBandwidth()),
+			m_L(A.Line() * (A.LowerBandwidth() + 1), T(0))
+		{
+			using std::sqrt;
+
+			const size_t N = m_Size;
+
+			for (size_t j = 0; j < N; ++j)
+			{
+				T d = A(j, j);
+
+				for (size_t k = this->First(j); k < j; ++k)
+					d -= this->At(j, k) * this->At(j, k);
+
+				if (!(d > T(0)))
+					throw std::exception("This matrix is not positive definite.");
+
+				d = sqrt(d);
+
+				this->At(j, j) = d;
+
+				for (size_t i = j + 1; i < std::min(N, j + m_Band + 1); ++i)
+				{
+					T sum = A(i, j);
+
+					for (size_t k = this->First(i); k < j; ++k)
+						sum -= this->At(i, k) * this->At(j, k);
+
+					this->At(i, j) = sum / d;
+				}
+			}
+		}
+
+		// X such that A X = B
+		HMatrix<T> Solve(HMatrix<T> B) const
+		{
+			ASSERT(B.Line() == m_Size);
+
+			const size_t N = m_Size;
+			const size_t R = B.Column();
+
+			T* b = B.Data();
+
+			// L Y = B
+			for (size_t i = 0; i < N; ++i)
+			{
+				for (size_t k = this->First(i); k < i; ++k)
+					for (size_t r = 0; r < R; ++r)
+						b[i * R + r] -= this->At(i, k) * b[k * R + r];
+
+				for (size_t r = 0; r < R; ++r)
+					b[i * R + r] /= this->At(i, i);
+			}
+
+			// L^T X = Y
+			for (size_t i = N; i-- > 0;)
+			{
+				for (size_t k = i + 1; k < std::min(N, i + m_Band + 1); ++k)
+					for (size_t r = 0; r < R; ++r)
+						b[i * R + r] -= this->At(k, i) * b[k * R + r];
+
+				for (size_t r = 0; r < R; ++r)
+					b[i * R + r] /= this->At(i, i);
+			}
+
+			return B;
+		}
+	};
+}
+
+template<typename T>
+struct ExpressionTraits<LCNMath::HBandMatrix<T>> : StoredMatrixTraits<0, 0>
+{
+	static constexpr bool Contiguous = false;
+};
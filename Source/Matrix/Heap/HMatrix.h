@@ -1,37 +1,156 @@
 #pragma once
 
+#include <algorithm>
+
+#include "../../_Matrix/MatrixBase.h"
+#include "../../_Matrix/Evaluation.h"
+
 namespace LCNMath
 {
 	///////////////////////////////
 	//-- Heap allocated Matrix --//
 	///////////////////////////////
 	template<typename T>
-	class HMatrix
+	class HMatrix : public MatrixBase<HMatrix<T>, T>
 	{
+	public:
+		using ValType = T;
+		using PtrType = T*;
+		using RefType = T&;
+
+		template<typename U>
+		using Rebind = HMatrix<U>;
+
 	private:
-		unsigned int m_Lines;
-		unsigned int m_Columns;
+		size_t m_Lines;
+		size_t m_Columns;
 
-		T** m_Matrix;
+		// Row major, single contiguous block : one allocation per matrix
+		// and a plain copy of the whole block on duplication.
+		T* m_Matrix;
 
 	public:
-		HMatrix(unsigned int L, unsigned int C) :
+		HMatrix(size_t L, size_t C) :
 			m_Lines(L),
 			m_Columns(C),
+			m_Matrix(new T[L * C])
+		{}
+
+		HMatrix(const HMatrix& other) :
+			m_Lines(other.m_Lines),
+			m_Columns(other.m_Columns),
+			m_Matrix(new T[other.m_Lines * other.m_Columns])
+		{
+			std::copy(other.m_Matrix, other.m_Matrix + m_Lines * m_Columns, m_Matrix);
+		}
+
+		HMatrix(HMatrix&& other) noexcept :
+			m_Lines(other.m_Lines),
+			m_Columns(other.m_Columns),
+			m_Matrix(other.m_Matrix)
+		{
+			other.m_Lines   = 0;
+			other.m_Columns = 0;
+			other.m_Matrix  = nullptr;
+		}
+
+		// Element wise expressions are written in place, the others are evaluated
+		// into their own block which is moved in : start empty
+		template<class E>
+		HMatrix(const MatrixExpression<E, ValType>& other) :
+			m_Lines(0),
+			m_Columns(0),
 			m_Matrix(nullptr)
 		{
-			m_Matrix = new T*[m_Lines];
+			if (ExpressionTraits<E>::ElementWise)
+				this->Resize(other.Line(), other.Column());
 
-			for (unsigned int i = 0; i < m_Lines; i++)
-				m_Matrix[i] = new T[m_Columns];
+			AssignExpression(*this, static_cast<const E&>(other));
 		}
 
 		virtual ~HMatrix()
 		{
-			for (unsigned int i = 0; i < m_Lines; i++)
-				delete[] m_Matrix[i];
-
 			delete[] m_Matrix;
 		}
+
+		HMatrix& operator=(const HMatrix& other)
+		{
+			if (this == &other)
+				return *this;
+
+			this->Resize(other.m_Lines, other.m_Columns);
+
+			std::copy(other.m_Matrix, other.m_Matrix + m_Lines * m_Columns, m_Matrix);
+
+			return *this;
+		}
+
+		HMatrix& operator=(HMatrix&& other) noexcept
+		{
+			std::swap(m_Lines,   other.m_Lines);
+			std::swap(m_Columns, other.m_Columns);
+			std::swap(m_Matrix,  other.m_Matrix);
+
+			return *this;
+		}
+
+		// The evaluation strategy comes from the expression traits, see Evaluation.h
+		template<class E>
+		HMatrix& operator=(const MatrixExpression<E, ValType>& other)
+		{
+			// Element wise expressions are written in place : keep the current block
+			if (ExpressionTraits<E>::ElementWise)
+				this->Resize(other.Line(), other.Column());
+
+			AssignExpression(*this, static_cast<const E&>(other));
+
+			return *this;
+		}
+
+		size_t Line()   const { return m_Lines; }
+		size_t Column() const { return m_Columns; }
+
+		RefType operator()(size_t i, size_t j) { return m_Matrix[i * m_Columns + j]; }
+		ValType operator()(size_t i, size_t j) const { return m_Matrix[i * m_Columns + j]; }
+
+		// Row major coefficients, the leading dimension is Column()
+		PtrType Data() { return m_Matrix; }
+		const T* Data() const { return m_Matrix; }
+
+		void AssertSquareMatrix() const { ASSERT(m_Lines == m_Columns); }
+
+		HMatrix Matrix2C() const
+		{
+			return HMatrix(m_Lines, 2 * m_Columns);
+		}
+
+		// Uninitialized matrix
+		static HMatrix Create(size_t L, size_t C)
+		{
+			return HMatrix(L, C);
+		}
+
+	private:
+		// Reuses the current block when the number of elements does not change
+		void Resize(size_t L, size_t C)
+		{
+			if (m_Lines * m_Columns != L * C)
+			{
+				T* block = new T[L * C];
+
+				delete[] m_Matrix;
+				m_Matrix = block;
+			}
+
+			m_Lines   = L;
+			m_Columns = C;
+		}
 	};
 }
+
+template<typename T>
+struct ExpressionTraits<LCNMath::HMatrix<T>> : StoredMatrixTraits<0, 0>
+{};
+
+// Products assigned to heap matrices go through the blocked kernels
+#include "HMatrixProduct.h"
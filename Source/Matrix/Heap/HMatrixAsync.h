@@ -0,0 +1,116 @@
+#pragma once
+
+#include <limits>
+#include <algorithm>
+
+#include "HMatrixProduct.h"
+#include "../../Utilities/Async.h"
+
+namespace LCNMath
+{
+	namespace Async
+	{
+		// Operands are taken by value : move them in to avoid the copy.
+		// Every operation checks for cancellation and reports its progress
+		// between two bands of lines (products) or two pivots (eliminations).
+
+		// Gauss-Jordan observer forwarding to the job control
+		struct GaussProgress
+		{
+			JobControl& Control;
+
+			void operator()(size_t done, size_t total) const
+			{
+				Control.ThrowIfCancelled();
+				Control.Report(float(done) / float(total));
+			}
+		};
+
+		// A * B with the blocked kernel, one band of GemmBlock lines at a time
+		template<typename T>
+		Task<HMatrix<T>> ProductAsync(HMatrix<T> A, HMatrix<T> B, ThreadPool& pool = ThreadPool::Shared())
+		{
+			ASSERT(A.Column() == B.Line());
+
+			return Run([A = std::move(A), B = std::move(B)](JobControl& control)
+			{
+				const size_t M    = A.Line();
+				const size_t K    = A.Column();
+				const size_t N    = B.Column();
+				const size_t band = Tuning::CurrentProfile().GemmBlock;
+
+				HMatrix<T> C(M, N);
+
+				for (size_t i = 0; i < M; i += band)
+				{
+					control.ThrowIfCancelled();
+
+					size_t lines = std::min(band, M - i);
+
+					BlockedProduct(A.Data() + i * K, K, B.Data(), N, C.Data() + i * N, N, lines, K, N);
+
+					control.Report(float(i + lines) / float(M));
+				}
+
+				return C;
+			}, pool);
+		}
+
+		// Same contract as MatrixBase::Invert(Pivoting, T&) followed by the check of Invert() :
+		// throws if the matrix is singular or too ill conditioned for the precision of T
+		template<typename T>
+		Task<HMatrix<T>> InvertAsync(HMatrix<T> A, Pivoting pivoting = Pivoting::Partial, ThreadPool& pool = ThreadPool::Shared())
+		{
+			A.AssertSquareMatrix();
+
+			return Run([A = std::move(A), pivoting](JobControl& control)
+			{
+				auto temp = A.AugmentedIdentity();
+
+				GaussResult<T> gauss = PivotedGaussElimination<T>(temp, temp.Line(), temp.Column(), pivoting, GaussProgress{ control });
+
+				HMatrix<T> result = A.RightBlock(temp);
+
+				if (gauss.Det == T(0) || A.RCond(result) < std::numeric_limits<RealScalar<T>>::epsilon())
+					throw std::exception("This matrix cannot be inverted.");
+
+				return result;
+			}, pool);
+		}
+
+		// X such that A X = B, by elimination of [A | B]. Throws if A is singular.
+		template<typename T>
+		Task<HMatrix<T>> SolveAsync(HMatrix<T> A, HMatrix<T> B, Pivoting pivoting = Pivoting::Partial, ThreadPool& pool = ThreadPool::Shared())
+		{
+			A.AssertSquareMatrix();
+
+			ASSERT(A.Line() == B.Line());
+
+			return Run([A = std::move(A), B = std::move(B), pivoting](JobControl& control)
+			{
+				const size_t N = A.Line();
+				const size_t R = B.Column();
+
+				HMatrix<T> temp(N, N + R);
+
+				for (size_t i = 0; i < N; ++i)
+				{
+					std::copy(A.Data() + i * N, A.Data() + (i + 1) * N, temp.Data() + i * (N + R));
+					std::copy(B.Data() + i * R, B.Data() + (i + 1) * R, temp.Data() + i * (N + R) + N);
+				}
+
+				GaussResult<T> gauss = PivotedGaussElimination<T>(temp, N, N + R, pivoting, GaussProgress{ control });
+
+				if (gauss.Det == T(0))
+					throw std::exception("This system has no unique solution.");
+
+				HMatrix<T> X(N, R);
+
+				for (size_t i = 0; i < N; ++i)
+					std::copy(temp.Data() + i * (N + R) + N, temp.Data() + (i + 1) * (N + R), X.Data() + i * R);
+
+				return X;
+			}, pool);
+		}
+	}
+}
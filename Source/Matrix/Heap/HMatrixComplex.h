@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <algorithm>
+
+#include "HMatrix.h"
+#include "../../Utilities/KernelTuning.h"
+
+namespace LCNMath
+{
+	//////////////////////
+	//-- Complex GEMM --//
+	//////////////////////
+
+	// C = A * B for complex matrices. std::complex interleaves real and imaginary parts,
+	// so a complex multiply-add shuffles lanes in SIMD registers. B and C are split in
+	// real and imaginary blocks instead, and the innermost loop becomes
+	//   Re C += Re a Re B - Im a Im B
+	//   Im C += Re a Im B + Im a Re B
+	// on contiguous real arrays, blocked like BlockedProduct.
+	template<typename T>
+	void ComplexProduct(const std::complex<T>* A, size_t lda, const std::complex<T>* B, size_t ldb, std::complex<T>* C, size_t ldc, size_t M, size_t K, size_t N)
+	{
+		const size_t GemmBlockSize = Tuning::CurrentProfile().GemmBlock;
+
+		std::vector<T> buffer(2 * K * N + 2 * M * N, T(0));
+
+		T* br = buffer.data();
+		T* bi = br + K * N;
+		T* cr = bi + K * N;
+		T* ci = cr + M * N;
+
+		for (size_t k = 0; k < K; ++k)
+			for (size_t j = 0; j < N; ++j)
+			{
+				br[k * N + j] = B[k * ldb + j].real();
+				bi[k * N + j] = B[k * ldb + j].imag();
+			}
+
+		for (size_t ii = 0; ii < M; ii += GemmBlockSize)
+		{
+			size_t iend = std::min(ii + GemmBlockSize, M);
+
+			for (size_t kk = 0; kk < K; kk += GemmBlockSize)
+			{
+				size_t kend = std::min(kk + GemmBlockSize, K);
+
+				for (size_t jj = 0; jj < N; jj += GemmBlockSize)
+				{
+					size_t jend = std::min(jj + GemmBlockSize, N);
+
+					for (size_t i = ii; i < iend; ++i)
+					{
+						T* re = cr + i * N;
+						T* im = ci + i * N;
+
+						for (size_t k = kk; k < kend; ++k)
+						{
+							const T ar = A[i * lda + k].real();
+							const T ai = A[i * lda + k].imag();
+
+							const T* bre = br + k * N;
+							const T* bim = bi + k * N;
+
+							for (size_t j = jj; j < jend; ++j)
+							{
+								re[j] += ar * bre[j] - ai * bim[j];
+								im[j] += ar * bim[j] + ai * bre[j];
+							}
+						}
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < M; ++i)
+			for (size_t j = 0; j < N; ++j)
+				C[i * ldc + j] = std::complex<T>(cr[i * N + j], ci[i * N + j]);
+	}
+
+	// Chosen over the generic Product for complex coefficients, expression assignment included
+	template<typename T>
+	HMatrix<std::complex<T>> Product(const HMatrix<std::complex<T>>& A, const HMatrix<std::complex<T>>& B)
+	{
+		ASSERT(A.Column() == B.Line());
+
+		HMatrix<std::complex<T>> C(A.Line(), B.Column());
+
+		ComplexProduct(A.Data(), A.Column(), B.Data(), B.Column(), C.Data(), C.Column(), A.Line(), A.Column(), B.Column());
+
+		return C;
+	}
+}
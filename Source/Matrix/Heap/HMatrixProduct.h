@@ -0,0 +1,331 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "HMatrix.h"
+#include "../../Utilities/SIMD.h"
+#include "../../Utilities/KernelTuning.h"
+
+namespace LCNMath
+{
+	// Kernels below work on row major views : a pointer to the first
+	// coefficient and the distance between two lines (leading dimension).
+
+	//////////////////////
+	//-- Blocked GEMM --//
+	//////////////////////
+
+	// C = A * B, or C += A * B if accumulate. A is M x K, B is K x N, C is M x N.
+	// block is the tile edge, read from the current profile unless given.
+	template<typename T>
+	void BlockedProduct(const T* A, size_t lda, const T* B, size_t ldb, T* C, size_t ldc, size_t M, size_t K, size_t N, bool accumulate = false, size_t block = Tuning::CurrentProfile().GemmBlock)
+	{
+		ASSERT(block > 0);
+
+		const size_t GemmBlockSize = block;
+
+		if (!accumulate)
+			for (size_t i = 0; i < M; ++i)
+				std::fill(C + i * ldc, C + i * ldc + N, T(0));
+
+		for (size_t ii = 0; ii < M; ii += GemmBlockSize)
+		{
+			size_t iend = std::min(ii + GemmBlockSize, M);
+
+			for (size_t kk = 0; kk < K; kk += GemmBlockSize)
+			{
+				size_t kend = std::min(kk + GemmBlockSize, K);
+
+				for (size_t jj = 0; jj < N; jj += GemmBlockSize)
+				{
+					size_t jend = std::min(jj + GemmBlockSize, N);
+
+					for (size_t i = ii; i < iend; ++i)
+					{
+						T* c = C + i * ldc;
+
+						for (size_t k = kk; k < kend; ++k)
+						{
+							const T  a = A[i * lda + k];
+							const T* b = B + k * ldb;
+
+							// Contiguous innermost loop, vectorized by the compiler
+							for (size_t j = jj; j < jend; ++j)
+								c[j] += a * b[j];
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// C -= A * B, for tiles small enough to stay in cache
+	template<typename T>
+	void SubtractProduct(const T* A, size_t lda, const T* B, size_t ldb, T* C, size_t ldc, size_t M, size_t K, size_t N)
+	{
+		for (size_t i = 0; i < M; ++i)
+			for (size_t k = 0; k < K; ++k)
+			{
+				T a = A[i * lda + k];
+
+				for (size_t j = 0; j < N; ++j)
+					C[i * ldc + j] -= a * B[k * ldb + j];
+			}
+	}
+
+	template<typename T>
+	HMatrix<T> BlockedProduct(const HMatrix<T>& A, const HMatrix<T>& B)
+	{
+		ASSERT(A.Column() == B.Line());
+
+		HMatrix<T> C(A.Line(), B.Column());
+
+		BlockedProduct(A.Data(), A.Column(), B.Data(), B.Column(), C.Data(), C.Column(), A.Line(), A.Column(), B.Column());
+
+		return C;
+	}
+
+	///////////////////////////////////
+	//-- Strassen-Winograd product --//
+	///////////////////////////////////
+
+	// Stack of scratch buffers for the recursion, allocated once
+	template<typename T>
+	class StrassenArena
+	{
+	private:
+		std::vector<T> m_Buffer;
+		size_t         m_Top = 0;
+
+	public:
+		StrassenArena() = default;
+
+		StrassenArena(size_t M, size_t K, size_t N, size_t crossover)
+		{
+			Reserve(M, K, N, crossover);
+		}
+
+		// Scratch needed by a M x K by K x N product
+		static size_t Requirement(size_t M, size_t K, size_t N, size_t crossover)
+		{
+			M &= ~size_t(1);
+			K &= ~size_t(1);
+			N &= ~size_t(1);
+
+			if (std::min(M, std::min(K, N)) < std::max(crossover, size_t(2)))
+				return 0;
+
+			size_t m = M / 2, k = K / 2, n = N / 2;
+
+			return 4 * m * k + 4 * k * n + 7 * m * n + Requirement(m, k, n, crossover);
+		}
+
+		void Reserve(size_t M, size_t K, size_t N, size_t crossover)
+		{
+			size_t size = Requirement(M, K, N, crossover);
+
+			if (m_Buffer.size() < size)
+				m_Buffer.resize(size);
+		}
+
+		size_t Mark() const { return m_Top; }
+
+		void Release(size_t mark) { m_Top = mark; }
+
+		T* Allocate(size_t count)
+		{
+			if (m_Top + count > m_Buffer.size())
+				throw std::out_of_range("Strassen arena too small.");
+
+			T* result = m_Buffer.data() + m_Top;
+
+			m_Top += count;
+
+			return result;
+		}
+	};
+
+	// c = a + b, or c = a - b if substract
+	template<typename T>
+	void AddBlocks(const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc, size_t M, size_t N, bool substract = false)
+	{
+		for (size_t i = 0; i < M; ++i)
+		{
+			const T* ai = a + i * lda;
+			const T* bi = b + i * ldb;
+			T*       ci = c + i * ldc;
+
+			if (substract)
+				for (size_t j = 0; j < N; ++j)
+					ci[j] = ai[j] - bi[j];
+			else
+				for (size_t j = 0; j < N; ++j)
+					ci[j] = ai[j] + bi[j];
+		}
+	}
+
+	// C = A * B with the Winograd variant of Strassen : 7 products and 15 additions
+	// per level. Below crossover, or on the odd line/column left over at each
+	// level, the blocked kernel is used, with tiles of edge block.
+	template<typename T>
+	void StrassenProduct(const T* A, size_t lda, const T* B, size_t ldb, T* C, size_t ldc, size_t M, size_t K, size_t N, size_t crossover, StrassenArena<T>& arena, size_t block = Tuning::CurrentProfile().GemmBlock)
+	{
+		size_t Me = M & ~size_t(1);
+		size_t Ke = K & ~size_t(1);
+		size_t Ne = N & ~size_t(1);
+
+		if (std::min(Me, std::min(Ke, Ne)) < std::max(crossover, size_t(2)))
+		{
+			BlockedProduct(A, lda, B, ldb, C, ldc, M, K, N, false, block);
+			return;
+		}
+
+		size_t m = Me / 2, k = Ke / 2, n = Ne / 2;
+
+		const T* A11 = A;
+		const T* A12 = A + k;
+		const T* A21 = A + m * lda;
+		const T* A22 = A21 + k;
+
+		const T* B11 = B;
+		const T* B12 = B + n;
+		const T* B21 = B + k * ldb;
+		const T* B22 = B21 + n;
+
+		T* C11 = C;
+		T* C12 = C + n;
+		T* C21 = C + m * ldc;
+		T* C22 = C21 + n;
+
+		size_t mark = arena.Mark();
+
+		T* S1 = arena.Allocate(m * k); T* S2 = arena.Allocate(m * k);
+		T* S3 = arena.Allocate(m * k); T* S4 = arena.Allocate(m * k);
+		T* T1 = arena.Allocate(k * n); T* T2 = arena.Allocate(k * n);
+		T* T3 = arena.Allocate(k * n); T* T4 = arena.Allocate(k * n);
+
+		AddBlocks(A21, lda, A22, lda, S1, k, m, k);
+		AddBlocks(S1,  k,   A11, lda, S2, k, m, k, true);
+		AddBlocks(A11, lda, A21, lda, S3, k, m, k, true);
+		AddBlocks(A12, lda, S2,  k,   S4, k, m, k, true);
+
+		AddBlocks(B12, ldb, B11, ldb, T1, n, k, n, true);
+		AddBlocks(B22, ldb, T1,  n,   T2, n, k, n, true);
+		AddBlocks(B22, ldb, B12, ldb, T3, n, k, n, true);
+		AddBlocks(T2,  n,   B21, ldb, T4, n, k, n, true);
+
+		T* P[7];
+
+		for (size_t i = 0; i < 7; ++i)
+			P[i] = arena.Allocate(m * n);
+
+		StrassenProduct(A11, lda, B11, ldb, P[0], n, m, k, n, crossover, arena, block);
+		StrassenProduct(A12, lda, B21, ldb, P[1], n, m, k, n, crossover, arena, block);
+		StrassenProduct(S4,  k,   B22, ldb, P[2], n, m, k, n, crossover, arena, block);
+		StrassenProduct(A22, lda, T4,  n,   P[3], n, m, k, n, crossover, arena, block);
+		StrassenProduct(S1,  k,   T1,  n,   P[4], n, m, k, n, crossover, arena, block);
+		StrassenProduct(S2,  k,   T2,  n,   P[5], n, m, k, n, crossover, arena, block);
+		StrassenProduct(S3,  k,   T3,  n,   P[6], n, m, k, n, crossover, arena, block);
+
+		AddBlocks(P[0], n, P[1], n, C11, ldc, m, n);        // C11 = P1 + P2
+		AddBlocks(P[0], n, P[5], n, P[5], n, m, n);         // U2  = P1 + P6
+		AddBlocks(P[5], n, P[6], n, P[6], n, m, n);         // U3  = U2 + P7
+		AddBlocks(P[5], n, P[4], n, P[5], n, m, n);         // U4  = U2 + P5
+		AddBlocks(P[5], n, P[2], n, C12, ldc, m, n);        // C12 = U4 + P3
+		AddBlocks(P[6], n, P[3], n, C21, ldc, m, n, true);  // C21 = U3 - P4
+		AddBlocks(P[6], n, P[4], n, C22, ldc, m, n);        // C22 = U3 + P5
+
+		arena.Release(mark);
+
+		// Odd leftovers : last column of A times last line of B, then last column and line of C
+		if (Ke != K)
+			BlockedProduct(A + Ke, lda, B + Ke * ldb, ldb, C, ldc, Me, 1, Ne, true, block);
+
+		if (Ne != N)
+			BlockedProduct(A, lda, B + Ne, ldb, C + Ne, ldc, Me, K, 1, false, block);
+
+		if (Me != M)
+			BlockedProduct(A + Me * lda, lda, B, ldb, C + Me * ldc, ldc, 1, K, N, false, block);
+	}
+
+	// Opt-in fast product for large heap matrices. The arena is resized if needed,
+	// reuse the same one across calls to avoid any allocation in steady state.
+	template<typename T>
+	HMatrix<T> StrassenProduct(const HMatrix<T>& A, const HMatrix<T>& B, StrassenArena<T>& arena, size_t crossover = Tuning::CurrentProfile().StrassenCrossover)
+	{
+		ASSERT(A.Column() == B.Line());
+
+		HMatrix<T> C(A.Line(), B.Column());
+
+		arena.Reserve(A.Line(), A.Column(), B.Column(), crossover);
+
+		StrassenProduct(A.Data(), A.Column(), B.Data(), B.Column(), C.Data(), C.Column(), A.Line(), A.Column(), B.Column(), crossover, arena);
+
+		return C;
+	}
+
+	template<typename T>
+	HMatrix<T> StrassenProduct(const HMatrix<T>& A, const HMatrix<T>& B, size_t crossover = Tuning::CurrentProfile().StrassenCrossover)
+	{
+		StrassenArena<T> arena(A.Line(), A.Column(), B.Column(), crossover);
+
+		return StrassenProduct(A, B, arena, crossover);
+	}
+
+	// Picks the kernel for this shape from the current profile
+	template<typename T>
+	HMatrix<T> Product(const HMatrix<T>& A, const HMatrix<T>& B, std::true_type)
+	{
+		const Tuning::KernelProfile& profile = Tuning::CurrentProfile();
+
+		size_t smallest = std::min(A.Line(), std::min(A.Column(), B.Column()));
+
+		if (profile.StrassenThreshold != 0 && smallest >= profile.StrassenThreshold)
+			return StrassenProduct(A, B, profile.StrassenCrossover);
+
+		return BlockedProduct(A, B);
+	}
+
+	// Narrow storage types (Half, BFloat16, Fixed) are widened once, multiplied by the
+	// kernels of their accumulator and rounded once : no sum is carried in T.
+	template<typename T>
+	HMatrix<T> Product(const HMatrix<T>& A, const HMatrix<T>& B, std::false_type)
+	{
+		using W = Accumulator<T>;
+
+		HMatrix<W> a(A.Line(), A.Column());
+		HMatrix<W> b(B.Line(), B.Column());
+
+		SIMD::Widen(A.Data(), a.Data(), A.Line() * A.Column());
+		SIMD::Widen(B.Data(), b.Data(), B.Line() * B.Column());
+
+		HMatrix<W> c = Product(a, b, std::true_type());
+		HMatrix<T> C(c.Line(), c.Column());
+
+		SIMD::Narrow(c.Data(), C.Data(), C.Line() * C.Column());
+
+		return C;
+	}
+
+	template<typename T>
+	HMatrix<T> Product(const HMatrix<T>& A, const HMatrix<T>& B)
+	{
+		return Product(A, B, std::is_same<T, Accumulator<T>>());
+	}
+
+	// Kernel used by expression assignment (see Evaluation.h)
+	template<typename T>
+	void EvaluateProduct(HMatrix<T>& out, const HMatrix<T>& a, const HMatrix<T>& b)
+	{
+		out = Product(a, b);
+	}
+}
+
+// Triangular solves of heap matrices go through the blocked TRSM
+#include "HMatrixTriangular.h"
+
+// Complex products go through the split real and imaginary kernel
+#include "HMatrixComplex.h"
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "HMatrixProduct.h"
+#include "../../Utilities/TaskGraph.h"
+#include "../../Utilities/KernelTuning.h"
+
+namespace LCNMath
+{
+	// Tiled factorizations expressed as a dependency graph of tile kernels and run
+	// by Async::TaskGraph : a step does not wait for the whole previous trailing
+	// update, only for the tiles it reads. The tile size defaults to GemmBlock.
+
+	//////////////////////
+	//-- Tile kernels --//
+	//////////////////////
+
+	// Row major views, ld is the distance between two lines
+
+	// C -= A * B^T, A is M x K, B is N x K. Only the lower triangle if lower.
+	template<typename T>
+	void SubtractProductTransposed(const T* A, const T* B, T* C, size_t ld, size_t M, size_t K, size_t N, bool lower = false)
+	{
+		for (size_t i = 0; i < M; ++i)
+			for (size_t j = 0; j < (lower ? i + 1 : N); ++j)
+			{
+				T sum(0);
+
+				for (size_t k = 0; k < K; ++k)
+					sum += A[i * ld + k] * B[j * ld + k];
+
+				C[i * ld + j] -= sum;
+			}
+	}
+
+	// LU with partial pivoting of the M x N panel (M >= N), pivots[c] receives the
+	// line, relative to the panel, swapped with line c. Only the panel columns are swapped.
+	template<typename T>
+	void PanelLU(T* A, size_t ld, size_t M, size_t N, size_t* pivots)
+	{
+		using std::abs;
+
+		for (size_t c = 0; c < N; ++c)
+		{
+			size_t p = c;
+
+			for (size_t r = c + 1; r < M; ++r)
+				if (abs(A[r * ld + c]) > abs(A[p * ld + c]))
+					p = r;
+
+			if (A[p * ld + c] == T(0))
+				throw std::exception("This matrix is singular.");
+
+			pivots[c] = p;
+
+			if (p != c)
+				std::swap_ranges(A + c * ld, A + c * ld + N, A + p * ld);
+
+			T inv = T(1) / A[c * ld + c];
+
+			for (size_t r = c + 1; r < M; ++r)
+			{
+				T factor = (A[r * ld + c] *= inv);
+
+				for (size_t k = c + 1; k < N; ++k)
+					A[r * ld + k] -= factor * A[c * ld + k];
+			}
+		}
+	}
+
+	// Applies the panel pivots to the M x N block B (M lines from the panel top), then
+	// B[0..K) = L^-1 B[0..K) with L the K x K unit lower triangle of the panel.
+	template<typename T>
+	void PanelSolve(const T* L, T* B, size_t ld, size_t K, size_t N, const size_t* pivots)
+	{
+		for (size_t c = 0; c < K; ++c)
+			if (pivots[c] != c)
+				std::swap_ranges(B + c * ld, B + c * ld + N, B + pivots[c] * ld);
+
+		for (size_t c = 0; c < K; ++c)
+			for (size_t r = c + 1; r < K; ++r)
+			{
+				T factor = L[r * ld + c];
+
+				for (size_t j = 0; j < N; ++j)
+					B[r * ld + j] -= factor * B[c * ld + j];
+			}
+	}
+
+	// Lower Cholesky factor of the N x N tile, in place (lower triangle only)
+	template<typename T>
+	void TileCholesky(T* A, size_t ld, size_t N)
+	{
+		using std::sqrt;
+
+		for (size_t j = 0; j < N; ++j)
+		{
+			T d = A[j * ld + j];
+
+			for (size_t k = 0; k < j; ++k)
+				d -= A[j * ld + k] * A[j * ld + k];
+
+			if (!(d > T(0)))
+				throw std::exception("This matrix is not positive definite.");
+
+			d = sqrt(d);
+
+			A[j * ld + j] = d;
+
+			for (size_t i = j + 1; i < N; ++i)
+			{
+				T sum = A[i * ld + j];
+
+				for (size_t k = 0; k < j; ++k)
+					sum -= A[i * ld + k] * A[j * ld + k];
+
+				A[i * ld + j] = sum / d;
+			}
+		}
+	}
+
+	// B = B * L^-T, L is the K x K lower triangle, B is M x K
+	template<typename T>
+	void SolveLowerTransposed(const T* L, T* B, size_t ld, size_t M, size_t K)
+	{
+		for (size_t i = 0; i < M; ++i)
+			for (size_t c = 0; c < K; ++c)
+			{
+				T sum = B[i * ld + c];
+
+				for (size_t k = 0; k < c; ++k)
+					sum -= B[i * ld + k] * L[c * ld + k];
+
+				B[i * ld + c] = sum / L[c * ld + c];
+			}
+	}
+
+	//////////////////
+	//-- Tiled LU --//
+	//////////////////
+
+	// P A = L U in place (unit lower L below the diagonal, U above), returns the
+	// LAPACK style pivots : line i was swapped with line pivots[i], in that order.
+	// Throws if a null pivot is met.
+	template<typename T>
+	std::vector<size_t> TiledLU(HMatrix<T>& A, size_t tile = 0, size_t threads = 0)
+	{
+		using Async::TaskGraph;
+
+		A.AssertSquareMatrix();
+
+		const size_t N  = A.Line();
+		const size_t nb = tile ? tile : Tuning::CurrentProfile().GemmBlock;
+		const size_t nt = (N + nb - 1) / nb;
+
+		T* a = A.Data();
+
+		std::vector<size_t> pivots(N);
+
+		TaskGraph graph;
+
+		// Last writers of each column of tiles
+		std::vector<std::vector<TaskGraph::Node>> writers(nt);
+
+		for (size_t k = 0; k < nt; ++k)
+		{
+			const size_t k0 = k * nb;
+			const size_t kb = std::min(nb, N - k0);
+
+			TaskGraph::Node panel = graph.Add([=, &pivots]
+			{
+				PanelLU(a + k0 * N + k0, N, N - k0, kb, &pivots[k0]);
+			}, true);
+
+			for (TaskGraph::Node writer : writers[k])
+				graph.Depend(panel, writer);
+
+			for (size_t j = k + 1; j < nt; ++j)
+			{
+				const size_t j0 = j * nb;
+				const size_t jb = std::min(nb, N - j0);
+
+				// The next column of tiles is on the critical path
+				const bool critical = (j == k + 1);
+
+				TaskGraph::Node solve = graph.Add([=, &pivots]
+				{
+					PanelSolve(a + k0 * N + k0, a + k0 * N + j0, N, kb, jb, &pivots[k0]);
+				}, critical);
+
+				graph.Depend(solve, panel);
+
+				for (TaskGraph::Node writer : writers[j])
+					graph.Depend(solve, writer);
+
+				writers[j].clear();
+
+				for (size_t i = k + 1; i < nt; ++i)
+				{
+					const size_t i0 = i * nb;
+					const size_t ib = std::min(nb, N - i0);
+
+					TaskGraph::Node update = graph.Add([=]
+					{
+						SubtractProduct(a + i0 * N + k0, N, a + k0 * N + j0, N, a + i0 * N + j0, N, ib, kb, jb);
+					}, critical);
+
+					graph.Depend(update, solve);
+
+					writers[j].push_back(update);
+				}
+			}
+		}
+
+		graph.Execute(threads);
+
+		// Pivots relative to their panel become absolute, and the swaps of each panel
+		// are applied to the columns of L on its left (deferred, they were read by the updates)
+		for (size_t k = 0; k < nt; ++k)
+		{
+			const size_t k0 = k * nb;
+			const size_t kb = std::min(nb, N - k0);
+
+			for (size_t c = k0; c < k0 + kb; ++c)
+			{
+				pivots[c] += k0;
+
+				if (pivots[c] != c)
+					std::swap_ranges(a + c * N, a + c * N + k0, a + pivots[c] * N);
+			}
+		}
+
+		return pivots;
+	}
+
+	////////////////////////
+	//-- Tiled Cholesky --//
+	////////////////////////
+
+	// A = L L^T for a symmetric positive definite A, only its lower triangle is read.
+	// L is written in place and the strict upper triangle is set to 0.
+	template<typename T>
+	void TiledCholesky(HMatrix<T>& A, size_t tile = 0, size_t threads = 0)
+	{
+		using Async::TaskGraph;
+
+		A.AssertSquareMatrix();
+
+		const size_t N  = A.Line();
+		const size_t nb = tile ? tile : Tuning::CurrentProfile().GemmBlock;
+		const size_t nt = (N + nb - 1) / nb;
+
+		T* a = A.Data();
+
+		auto origin = [=](size_t t) { return t * nb; };
+		auto extent = [=](size_t t) { return std::min(nb, N - t * nb); };
+
+		TaskGraph graph;
+
+		// Last writer of each tile of the lower triangle
+		std::vector<TaskGraph::Node> writers(nt * nt, TaskGraph::Node(-1));
+
+		auto depend = [&](TaskGraph::Node node, size_t i, size_t j)
+		{
+			if (writers[i * nt + j] != TaskGraph::Node(-1))
+				graph.Depend(node, writers[i * nt + j]);
+		};
+
+		for (size_t k = 0; k < nt; ++k)
+		{
+			const size_t k0 = origin(k);
+			const size_t kb = extent(k);
+
+			TaskGraph::Node factor = graph.Add([=] { TileCholesky(a + k0 * N + k0, N, kb); }, true);
+
+			depend(factor, k, k);
+			writers[k * nt + k] = factor;
+
+			for (size_t i = k + 1; i < nt; ++i)
+			{
+				const size_t i0 = origin(i);
+
+				TaskGraph::Node solve = graph.Add([=] { SolveLowerTransposed(a + k0 * N + k0, a + i0 * N + k0, N, extent(i), kb); }, true);
+
+				graph.Depend(solve, factor);
+				depend(solve, i, k);
+				writers[i * nt + k] = solve;
+			}
+
+			for (size_t i = k + 1; i < nt; ++i)
+			{
+				const size_t i0 = origin(i);
+
+				for (size_t j = k + 1; j <= i; ++j)
+				{
+					const size_t j0 = origin(j);
+
+					// Updates of the next column of tiles are on the critical path
+					TaskGraph::Node update = graph.Add([=]
+					{
+						SubtractProductTransposed(a + i0 * N + k0, a + j0 * N + k0, a + i0 * N + j0, N, extent(i), kb, extent(j), i == j);
+					}, j == k + 1);
+
+					graph.Depend(update, writers[i * nt + k]);
+
+					if (j != i)
+						graph.Depend(update, writers[j * nt + k]);
+
+					depend(update, i, j);
+					writers[i * nt + j] = update;
+				}
+			}
+		}
+
+		graph.Execute(threads);
+
+		for (size_t i = 0; i < N; ++i)
+			std::fill(a + i * N + i + 1, a + (i + 1) * N, T(0));
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+
+#include "HMatrixProduct.h"
+#include "../../_Matrix/TriangularView.h"
+#include "../../Utilities/KernelTuning.h"
+
+namespace LCNMath
+{
+	//////////////////////
+	//-- Blocked TRSM --//
+	//////////////////////
+
+	// B = op(A)^-1 B with A the N x N triangle given by Mode and B N x R. The diagonal
+	// blocks are solved by substitution, the rest of B is updated block by block with
+	// products, so most of the work runs in cache.
+	template<unsigned Mode, typename T>
+	void BlockedTriangularSolve(const T* A, size_t lda, T* B, size_t ldb, size_t N, size_t R, size_t block)
+	{
+		const bool lower = (Mode & TriangularMode::Lower) != 0;
+		const bool unit  = (Mode & TriangularMode::UnitDiag) != 0;
+
+		const size_t blocks = (N + block - 1) / block;
+
+		for (size_t n = 0; n < blocks; ++n)
+		{
+			const size_t k0 = (lower ? n : blocks - 1 - n) * block;
+			const size_t kb = std::min(block, N - k0);
+
+			// Diagonal block
+			for (size_t m = 0; m < kb; ++m)
+			{
+				size_t r = k0 + (lower ? m : kb - 1 - m);
+
+				for (size_t c = (lower ? k0 : r + 1); c < (lower ? r : k0 + kb); ++c)
+				{
+					T factor = A[r * lda + c];
+
+					for (size_t j = 0; j < R; ++j)
+						B[r * ldb + j] -= factor * B[c * ldb + j];
+				}
+
+				if (!unit)
+				{
+					T diag = A[r * lda + r];
+
+					if (diag == T(0))
+						throw std::exception("This triangular matrix is singular.");
+
+					T inv = T(1) / diag;
+
+					for (size_t j = 0; j < R; ++j)
+						B[r * ldb + j] *= inv;
+				}
+			}
+
+			// Lines still to solve : below the block if lower, above if upper
+			if (lower)
+				SubtractProduct(A + (k0 + kb) * lda + k0, lda, B + k0 * ldb, ldb, B + (k0 + kb) * ldb, ldb, N - k0 - kb, kb, R);
+			else
+				SubtractProduct(A + k0, lda, B + k0 * ldb, ldb, B, ldb, k0, kb, R);
+		}
+	}
+
+	// Picked by TriangularView::SolveInPlace for heap matrices
+	template<unsigned Mode, typename T>
+	void TriangularSolve(const HMatrix<T>& a, HMatrix<T>& b)
+	{
+		ASSERT(a.Line() == a.Column() && b.Line() == a.Line());
+
+		BlockedTriangularSolve<Mode>(a.Data(), a.Column(), b.Data(), b.Column(), a.Line(), b.Column(), Tuning::CurrentProfile().GemmBlock);
+	}
+}
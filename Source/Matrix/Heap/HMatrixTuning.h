@@ -0,0 +1,266 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include <complex>
+
+#include "HMatrixProduct.h"
+#include "../../_Matrix/StaticMatrix.h"
+
+namespace LCNMath
+{
+	namespace Tuning
+	{
+		// Best of a few runs, in seconds
+		template<class F>
+		double MeasureKernel(F kernel, int runs = 3)
+		{
+			double best = std::numeric_limits<double>::max();
+
+			for (int i = 0; i < runs; ++i)
+			{
+				auto start = std::chrono::steady_clock::now();
+
+				kernel();
+
+				auto stop = std::chrono::steady_clock::now();
+
+				best = std::min(best, std::chrono::duration<double>(stop - start).count());
+			}
+
+			return best;
+		}
+
+		// Micro-benchmarks the candidate parameters on n x n double products and
+		// returns the fastest profile. Takes a few seconds for n = 1024 : run it once
+		// (at first use or from an offline tool) and persist it with Save(). Candidates
+		// are passed to the kernels, the current profile is neither read nor changed.
+		inline KernelProfile Tune(size_t n = 1024)
+		{
+			KernelProfile result = KernelProfile::FromCache(CacheInfo::Detect());
+
+			HMatrix<double> A(n, n), B(n, n), C(n, n);
+
+			std::mt19937 gen(0);
+			std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+			for (size_t i = 0; i < n; ++i)
+				for (size_t j = 0; j < n; ++j)
+				{
+					A(i, j) = dist(gen);
+					B(i, j) = dist(gen);
+				}
+
+			// Tile size on a product small enough to be fast
+			size_t small = std::min(n, size_t(384));
+			double best  = std::numeric_limits<double>::max();
+
+			for (size_t block : { 16, 32, 48, 64, 96, 128, 192, 256 })
+			{
+				double time = MeasureKernel([&]() { BlockedProduct(A.Data(), n, B.Data(), n, C.Data(), n, small, small, small, false, block); });
+
+				if (time < best)
+				{
+					best             = time;
+					result.GemmBlock = block;
+				}
+			}
+
+			const size_t gemmblock = result.GemmBlock;
+
+			// Strassen-Winograd crossover, kept only if it beats the blocked kernel at size n
+			double blocked = MeasureKernel([&]() { BlockedProduct(A.Data(), n, B.Data(), n, C.Data(), n, n, n, n, false, gemmblock); }, 1);
+			double fastest = blocked;
+
+			StrassenArena<double> arena;
+
+			for (size_t crossover : { 64, 128, 256, 512 })
+			{
+				if (crossover >= n)
+					break;
+
+				arena.Reserve(n, n, n, crossover);
+
+				double time = MeasureKernel([&]() { StrassenProduct(A.Data(), n, B.Data(), n, C.Data(), n, n, n, n, crossover, arena, gemmblock); }, 1);
+
+				if (time < fastest)
+				{
+					fastest                  = time;
+					result.StrassenCrossover = crossover;
+					result.StrassenThreshold = n;
+				}
+			}
+
+			return result;
+		}
+
+		struct StrassenBenchmark
+		{
+			size_t Size;
+			size_t Crossover;
+			double Blocked;   // Seconds for the blocked product
+			double Strassen;  // Seconds for Strassen-Winograd
+			double MaxError;  // Largest difference to the blocked product, relative to its largest coefficient
+		};
+
+		// Throughput and accuracy of Strassen-Winograd against the blocked product on
+		// n x n random products, for every size and every crossover below it
+		template<typename T = double>
+		std::vector<StrassenBenchmark> BenchmarkStrassen(const std::vector<size_t>& sizes = { 512, 1024, 2048 }, const std::vector<size_t>& crossovers = { 64, 128, 256 })
+		{
+			using std::abs;
+
+			std::vector<StrassenBenchmark> result;
+
+			std::mt19937 gen(0);
+			std::uniform_real_distribution<T> dist(T(-1), T(1));
+
+			for (size_t n : sizes)
+			{
+				std::vector<T> A(n * n), B(n * n), C(n * n), R(n * n);
+
+				for (size_t i = 0; i < n * n; ++i)
+				{
+					A[i] = dist(gen);
+					B[i] = dist(gen);
+				}
+
+				double blocked = MeasureKernel([&]() { BlockedProduct(A.data(), n, B.data(), n, R.data(), n, n, n, n); }, 1);
+
+				T scale(0);
+
+				for (T r : R)
+					scale = std::max(scale, abs(r));
+
+				StrassenArena<T> arena;
+
+				for (size_t crossover : crossovers)
+				{
+					if (crossover >= n)
+						continue;
+
+					arena.Reserve(n, n, n, crossover);
+
+					StrassenBenchmark bench;
+
+					bench.Size      = n;
+					bench.Crossover = crossover;
+					bench.Blocked   = blocked;
+					bench.Strassen  = MeasureKernel([&]() { StrassenProduct(A.data(), n, B.data(), n, C.data(), n, n, n, n, crossover, arena); }, 1);
+
+					T error(0);
+
+					for (size_t i = 0; i < n * n; ++i)
+						error = std::max(error, abs(C[i] - R[i]));
+
+					bench.MaxError = double(error / scale);
+
+					result.push_back(bench);
+				}
+			}
+
+			return result;
+		}
+
+		struct ComplexProductTimes
+		{
+			double Naive;  // Triple loop on std::complex
+			double Split;  // ComplexProduct
+		};
+
+		// Times of an n x n complex product with both kernels, in seconds
+		template<typename T = double>
+		ComplexProductTimes BenchmarkComplexProduct(size_t n = 256)
+		{
+			using C = std::complex<T>;
+
+			std::vector<C> A(n * n), B(n * n), R(n * n);
+
+			std::mt19937 gen(0);
+			std::uniform_real_distribution<T> dist(T(-1), T(1));
+
+			for (size_t i = 0; i < n * n; ++i)
+			{
+				A[i] = C(dist(gen), dist(gen));
+				B[i] = C(dist(gen), dist(gen));
+			}
+
+			ComplexProductTimes times;
+
+			times.Naive = MeasureKernel([&]()
+			{
+				std::fill(R.begin(), R.end(), C(0));
+
+				for (size_t i = 0; i < n; ++i)
+					for (size_t k = 0; k < n; ++k)
+					{
+						C a = A[i * n + k];
+
+						for (size_t j = 0; j < n; ++j)
+							R[i * n + j] += a * B[k * n + j];
+					}
+			});
+
+			times.Split = MeasureKernel([&]() { ComplexProduct(A.data(), n, B.data(), n, R.data(), n, n, n, n); });
+
+			return times;
+		}
+
+		struct GaussEliminationTimes
+		{
+			double Unrolled;  // Template recursive kernel (GaussEliminationUnrolled)
+			double Loop;      // Runtime loops of MatrixBase (GaussEliminationLoop)
+		};
+
+		// Time of one L x C elimination with both kernels, in seconds, averaged over
+		// count random matrices. Both include the copy of the matrix being reduced.
+		template<typename T, size_t L, size_t C>
+		GaussEliminationTimes BenchmarkGaussElimination(size_t count = 4096)
+		{
+			using M = StaticMatrix<T, L, C>;
+
+			std::vector<M> source(count), work(count);
+
+			std::mt19937 gen(0);
+			std::uniform_real_distribution<T> dist(T(-1), T(1));
+
+			for (M& m : source)
+				for (size_t i = 0; i < L; ++i)
+					for (size_t j = 0; j < C; ++j)
+						m(i, j) = dist(gen);
+
+			// Keeps the determinants alive so that the eliminations are not optimized away
+			volatile T sink = T(0);
+
+			GaussEliminationTimes times;
+
+			times.Unrolled = MeasureKernel([&]()
+			{
+				T sum(0);
+
+				work = source;
+
+				for (M& m : work)
+					sum += m.GaussEliminationUnrolled();
+
+				sink = sum;
+			}) / double(count);
+
+			times.Loop = MeasureKernel([&]()
+			{
+				T sum(0);
+
+				work = source;
+
+				for (M& m : work)
+					sum += m.GaussEliminationLoop();
+
+				sink = sum;
+			}) / double(count);
+
+			return times;
+		}
+	}
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "HMatrix.h"
+
+namespace LCNMath
+{
+	/////////////////////////////////
+	//-- Packed symmetric matrix --//
+	/////////////////////////////////
+
+	// Only the lower triangle is stored, line after line : N (N + 1) / 2 coefficients.
+	// (i, j) and (j, i) are the same coefficient.
+	template<typename T>
+	class HSymmetricMatrix : public MatrixExpression<HSymmetricMatrix<T>, T>
+	{
+	public:
+		using ValType = T;
+		using PtrType = T*;
+		using RefType = T&;
+
+	private:
+		size_t         m_Size;
+		std::vector<T> m_Packed;
+
+	public:
+		explicit HSymmetricMatrix(size_t N) :
+			m_Size(N),
+			m_Packed(N * (N + 1) / 2)
+		{}
+
+		// Only the lower triangle of the expression is read
+		template<class E>
+		HSymmetricMatrix(const MatrixExpression<E, ValType>& other) :
+			m_Size(0)
+		{
+			*this = other;
+		}
+
+		template<class E>
+		HSymmetricMatrix& operator=(const MatrixExpression<E, ValType>& other)
+		{
+			this->Pack(static_cast<const E&>(other), std::integral_constant<bool, ExpressionTraits<E>::ContainsProduct>());
+
+			return *this;
+		}
+
+		size_t Line()   const { return m_Size; }
+		size_t Column() const { return m_Size; }
+
+		RefType operator()(size_t i, size_t j) { return m_Packed[Index(i, j)]; }
+		ValType operator()(size_t i, size_t j) const { return m_Packed[Index(i, j)]; }
+
+		// Packed lower triangle, line i starts at Index(i, 0)
+		PtrType Data() { return m_Packed.data(); }
+		const T* Data() const { return m_Packed.data(); }
+
+		static size_t Index(size_t i, size_t j)
+		{
+			if (i < j)
+				std::swap(i, j);
+
+			return i * (i + 1) / 2 + j;
+		}
+
+	private:
+		// Computed in a new block : the expression may read this matrix
+		template<class E>
+		void Pack(const E& e, std::false_type)
+		{
+			ASSERT(e.Line() == e.Column());
+
+			size_t         N = e.Line();
+			std::vector<T> packed(N * (N + 1) / 2);
+
+			for (size_t i = 0; i < N; ++i)
+				for (size_t j = 0; j <= i; ++j)
+					packed[i * (i + 1) / 2 + j] = e(i, j);
+
+			m_Size = N;
+			m_Packed.swap(packed);
+		}
+
+		// Products are evaluated once by their kernels rather than element by element
+		template<class E>
+		void Pack(const E& e, std::true_type)
+		{
+			HMatrix<T> full = e;
+
+			this->Pack(full, std::false_type());
+		}
+	};
+
+	///////////////////////////
+	//-- Symmetric kernels --//
+	///////////////////////////
+
+	// Y = S X, each stored coefficient of S is read once (SYMM, SYMV for one column)
+	template<typename T>
+	void SymmetricProduct(const HSymmetricMatrix<T>& S, const T* X, size_t ldx, T* Y, size_t ldy, size_t R)
+	{
+		const size_t N = S.Line();
+		const T*     s = S.Data();
+
+		for (size_t i = 0; i < N; ++i)
+			std::fill(Y + i * ldy, Y + i * ldy + R, T(0));
+
+		for (size_t i = 0; i < N; ++i)
+		{
+			const T* line = s + i * (i + 1) / 2;
+
+			for (size_t j = 0; j < i; ++j)
+			{
+				T a = line[j];
+
+				for (size_t r = 0; r < R; ++r)
+				{
+					Y[i * ldy + r] += a * X[j * ldx + r];
+					Y[j * ldy + r] += a * X[i * ldx + r];
+				}
+			}
+
+			for (size_t r = 0; r < R; ++r)
+				Y[i * ldy + r] += line[i] * X[i * ldx + r];
+		}
+	}
+
+	// Picked by expression assignment for S * B
+	template<typename T>
+	void EvaluateProduct(HMatrix<T>& out, const HSymmetricMatrix<T>& a, const HMatrix<T>& b)
+	{
+		ASSERT(a.Column() == b.Line());
+
+		SymmetricProduct(a, b.Data(), b.Column(), out.Data(), out.Column(), b.Column());
+	}
+
+	// alpha A A^T, or alpha A^T A if transpose (SYRK) : only the lower triangle is computed
+	template<typename T>
+	HSymmetricMatrix<T> SymmetricRankK(const HMatrix<T>& A, bool transpose = false, T alpha = T(1))
+	{
+		const size_t N = transpose ? A.Column() : A.Line();
+		const size_t K = transpose ? A.Line() : A.Column();
+		const T*     a = A.Data();
+
+		HSymmetricMatrix<T> C(N);
+
+		T* c = C.Data();
+
+		if (!transpose)
+		{
+			// Dot products of contiguous lines
+			for (size_t i = 0; i < N; ++i)
+				for (size_t j = 0; j <= i; ++j)
+				{
+					T sum(0);
+
+					for (size_t k = 0; k < K; ++k)
+						sum += a[i * K + k] * a[j * K + k];
+
+					c[i * (i + 1) / 2 + j] = alpha * sum;
+				}
+		}
+		else
+		{
+			// Rank one update per line of A
+			std::fill(c, c + N * (N + 1) / 2, T(0));
+
+			for (size_t k = 0; k < K; ++k)
+			{
+				const T* line = a + k * N;
+
+				for (size_t i = 0; i < N; ++i)
+				{
+					T ai = alpha * line[i];
+
+					for (size_t j = 0; j <= i; ++j)
+						c[i * (i + 1) / 2 + j] += ai * line[j];
+				}
+			}
+		}
+
+		return C;
+	}
+}
+
+template<typename T>
+struct ExpressionTraits<LCNMath::HSymmetricMatrix<T>> : StoredMatrixTraits<0, 0>
+{
+	static constexpr bool Contiguous = false;
+};
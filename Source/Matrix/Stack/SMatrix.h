@@ -1,9 +1,14 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
 #include <initializer_list>
 
+#include "../../_Matrix/GaussElimination.h"
+#include "../../Utilities/Instrumentation.h"
+
 using uint = unsigned int;
 
 namespace LCNMath {
@@ -25,8 +30,7 @@ namespace LCNMath {
 				//-- Constructors and destructors --//
 				//////////////////////////////////////
 
-				Matrix()
-				{}
+				Matrix() = default;
 
 				Matrix(T value)
 				{
@@ -53,12 +57,13 @@ namespace LCNMath {
 				Matrix(const T mat[L][C])
 				{
 					for (uint i = 0; i < L; i++)
-						memcpy(m_Matrix[i], mat[i], C * sizeof(T));
+						std::copy(mat[i], mat[i] + C, m_Matrix[i]);
 				}
 
-				Matrix(const Matrix& mat) :
-					Matrix(mat.m_Matrix)
-				{}
+				// Copies and moves are left to the compiler so that the matrix
+				// stays trivially copyable (see the static_assert below).
+				Matrix(const Matrix&) = default;
+				Matrix(Matrix&&) = default;
 
 #pragma endregion
 
@@ -93,6 +98,17 @@ namespace LCNMath {
 					return m_Matrix[i][j];
 				}
 
+				// Row major coefficients, L * C contiguous values
+				T* Data()
+				{
+					return &m_Matrix[0][0];
+				}
+
+				const T* Data() const
+				{
+					return &m_Matrix[0][0];
+				}
+
 				template<uint L2, uint C2>
 				Matrix<T, L2, C2> SubMatrix(uint posi, uint posj) const
 				{
@@ -162,19 +178,54 @@ namespace LCNMath {
 
 				T GaussElimination()
 				{
+					return GaussElimination(UseUnrolledGauss<L, C>());
+				}
+
+				T GaussEliminationUnrolled()
+				{
+					LCN_INSTRUMENT("GaussElimination", L, C, GaussFlops(L, C), L * C * sizeof(T));
+
+					T work[L][C];
+
+					for (uint i = 0; i < L; i++)
+						for (uint j = 0; j < C; j++)
+							work[i][j] = m_Matrix[i][j];
+
+					T result = UnrolledGaussElimination(work);
+
+					for (uint i = 0; i < L; i++)
+						for (uint j = 0; j < C; j++)
+							m_Matrix[i][j] = work[i][j];
+
+					return result;
+				}
+
+				GaussResult<T> GaussElimination(Pivoting pivoting)
+				{
+					LCN_INSTRUMENT("PivotedGaussElimination", L, C, GaussFlops(L, C), L * C * sizeof(T));
+
+					return PivotedGaussElimination<T>(*this, L, C, pivoting);
+				}
+
+				T GaussEliminationLoop()
+				{
+					LCN_INSTRUMENT("GaussElimination", L, C, GaussFlops(L, C), L * C * sizeof(T));
+
 					uint linepivot    = 0;
 					uint permutations = 0;
 					T    pseudodet(1);
 
+					using std::abs;
+
 					for (uint j = 0; j < std::min(L, C); j++)
 					{
 						// Recherche du pivot
-						T   max    = 0;
+						RealScalar<T> max(0);
 						int maxpos = 0;
 
 						for (uint i = linepivot; i < L; i++)
 						{
-							if (std::abs(m_Matrix[i][j]) > max)
+							if (abs(m_Matrix[i][j]) > max)
 							{
 								max    = abs(m_Matrix[i][j]);
 								maxpos = i;
@@ -182,7 +233,7 @@ namespace LCNMath {
 						}
 
 						// maxpos est le pivot
-						if (m_Matrix[maxpos][j] == 0)
+						if (m_Matrix[maxpos][j] == T(0))
 							return T(0);
 
 						pseudodet *= m_Matrix[maxpos][j];
@@ -207,18 +258,18 @@ namespace LCNMath {
 
 #pragma endregion
 
+			private:
+				T GaussElimination(std::true_type)  { return GaussEliminationUnrolled(); }
+				T GaussElimination(std::false_type) { return GaussEliminationLoop(); }
+
+			public:
 #pragma region Operators_Overload
 				////////////////////////////
 				//-- Operators overload --//
 				////////////////////////////
 
-				Matrix& operator=(const Matrix& mat)
-				{
-					for (uint i = 0; i < L; i++)
-						memcpy(m_Matrix[i], mat.m_Matrix[i], C * sizeof(T));
-
-					return *this;
-				}
+				Matrix& operator=(const Matrix&) = default;
+				Matrix& operator=(Matrix&&) = default;
 
 				Matrix& operator+=(const Matrix& mat)
 				{
@@ -269,6 +320,8 @@ namespace LCNMath {
 #pragma endregion
 			};
 
+			static_assert(std::is_trivially_copyable<Matrix<float, 4, 4>>::value, "Matrix must remain trivially copyable.");
+
 #pragma region External_Functions
 			////////////////////////////
 			//-- External functions --//
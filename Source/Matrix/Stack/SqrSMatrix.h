@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include "SMatrix.h"
 
 namespace LCNMath {
@@ -56,14 +58,19 @@ namespace LCNMath {
 
 				T Det() const
 				{
+					LCN_INSTRUMENT("Det", LC, LC, GaussFlops(LC, LC), LC * LC * sizeof(T));
+
 					static SqrMatrix temp;
 					temp = *this;
 
 					return temp.GaussElimination();
 				}
 
+				// Throws if the matrix is singular or too ill conditioned for the precision of T
 				SqrMatrix Invert() const
 				{
+					LCN_INSTRUMENT("Invert", LC, LC, GaussFlops(LC, 2 * LC), 2 * LC * LC * sizeof(T));
+
 					static Matrix<T, LC, 2 * LC> temp;
 
 					temp.SubMatrix(*this, 0, 0);
@@ -71,10 +78,41 @@ namespace LCNMath {
 
 					T pseudodet = temp.GaussElimination();
 
-					if (std::abs(pseudodet) < T(0.0001))
+					SqrMatrix result = temp.template SubMatrix<LC, LC>(0, LC);
+
+					if (pseudodet == T(0) || RCond(result) < std::numeric_limits<RealScalar<T>>::epsilon())
+						throw std::exception("This matrix cannot be inverted.");
+
+					return result;
+				}
+
+				// Only throws if a null pivot is met. rcond receives the reciprocal condition
+				// number in norm 1, so that callers can decide to retry in higher precision.
+				SqrMatrix Invert(Pivoting pivoting, RealScalar<T>& rcond) const
+				{
+					LCN_INSTRUMENT("PivotedInvert", LC, LC, GaussFlops(LC, 2 * LC), 2 * LC * LC * sizeof(T));
+
+					static Matrix<T, LC, 2 * LC> temp;
+
+					temp.SubMatrix(*this, 0, 0);
+					temp.SubMatrix(SqrMatrix::Identity(), 0, LC);
+
+					GaussResult<T> gauss = PivotedGaussElimination<T>(temp, LC, 2 * LC, pivoting);
+
+					if (gauss.Det == T(0))
 						throw std::exception("This matrix cannot be inverted.");
 
-					return temp.SubMatrix<LC, LC>(0, LC);
+					SqrMatrix result = temp.template SubMatrix<LC, LC>(0, LC);
+
+					rcond = RCond(result);
+
+					return result;
+				}
+
+				// Reciprocal condition number in norm 1, given the inverse of this matrix
+				RealScalar<T> RCond(const SqrMatrix& inverse) const
+				{
+					return RealScalar<T>(1) / (NormOne<T>(*this, LC, LC) * NormOne<T>(inverse, LC, LC));
 				}
 
 #pragma endregion
@@ -92,6 +130,8 @@ namespace LCNMath {
 
 #pragma endregion
 			};
+
+			static_assert(std::is_trivially_copyable<SqrMatrix<float, 4>>::value, "SqrMatrix must remain trivially copyable.");
 		}
 	}
 }
\ No newline at end of file
@@ -1,4 +1,22 @@
 #pragma once
 
-#define PI 3.14159265
-#define TORAD(A) (PI * A) / 180
\ No newline at end of file
+namespace LCNMath {
+	namespace Angles {
+
+		// Rounded to the precision of T, no detour through double
+		template<typename T>
+		constexpr T Pi = T(3.14159265358979323846264338327950288L);
+
+		template<typename T>
+		constexpr T ToRad(T a)
+		{
+			return a * (Pi<T> / T(180));
+		}
+
+		template<typename T>
+		constexpr T ToDeg(T a)
+		{
+			return a * (T(180) / Pi<T>);
+		}
+	}
+}
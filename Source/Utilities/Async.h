@@ -0,0 +1,439 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+// Tasks are awaitable from C++20 coroutines when the compiler supports them
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define LCN_COROUTINES
+#endif
+#endif
+
+namespace LCNMath {
+	namespace Async {
+
+		/////////////////////
+		//-- Thread pool --//
+		/////////////////////
+
+		class ThreadPool
+		{
+		public:
+			explicit ThreadPool(size_t threads = std::thread::hardware_concurrency())
+			{
+				if (threads == 0)
+					threads = 1;
+
+				for (size_t i = 0; i < threads; ++i)
+					m_Workers.emplace_back([this] { this->Work(); });
+			}
+
+			ThreadPool(const ThreadPool&)            = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			// Jobs already queued are run before the workers stop
+			~ThreadPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					m_Stopping = true;
+				}
+
+				m_Condition.notify_all();
+
+				for (std::thread& worker : m_Workers)
+					worker.join();
+			}
+
+			// Pool shared by every asynchronous operation of the library
+			static ThreadPool& Shared()
+			{
+				static ThreadPool pool;
+
+				return pool;
+			}
+
+			size_t Size() const { return m_Workers.size(); }
+
+			void Post(std::function<void()> job)
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					m_Jobs.push_back(std::move(job));
+				}
+
+				m_Condition.notify_one();
+			}
+
+		private:
+			void Work()
+			{
+				while (true)
+				{
+					std::function<void()> job;
+
+					{
+						std::unique_lock<std::mutex> lock(m_Mutex);
+
+						m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+
+						if (m_Jobs.empty())
+							return;
+
+						job = std::move(m_Jobs.front());
+						m_Jobs.pop_front();
+					}
+
+					job();
+				}
+			}
+
+			std::vector<std::thread>          m_Workers;
+			std::deque<std::function<void()>> m_Jobs;
+			std::mutex                        m_Mutex;
+			std::condition_variable           m_Condition;
+			bool                              m_Stopping = false;
+		};
+
+		///////////////////
+		//-- Fork join --//
+		///////////////////
+
+		// Runs a() on the pool and b() on the calling thread, returns when both are done.
+		// If no pool thread has started a() once b() returns, the calling thread runs it :
+		// Invoke never waits for a busy pool, so it may be nested inside pool jobs.
+		template<class A, class B>
+		void Invoke(ThreadPool& pool, const A& a, const B& b)
+		{
+			struct State
+			{
+				std::atomic<bool>       Claimed{ false };
+				std::mutex              Mutex;
+				std::condition_variable Done;
+				bool                    Finished = false;
+				std::exception_ptr      Error;
+			};
+
+			// Outlives this call when the pool job starts late, the job then leaves at once
+			auto state = std::make_shared<State>();
+
+			pool.Post([state, &a]
+			{
+				if (state->Claimed.exchange(true))
+					return;
+
+				try
+				{
+					a();
+				}
+				catch (...)
+				{
+					state->Error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(state->Mutex);
+
+				state->Finished = true;
+				state->Done.notify_one();
+			});
+
+			std::exception_ptr error;
+
+			try
+			{
+				b();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			if (!state->Claimed.exchange(true))
+			{
+				if (!error)
+					a();
+			}
+			else
+			{
+				std::unique_lock<std::mutex> lock(state->Mutex);
+
+				state->Done.wait(lock, [&] { return state->Finished; });
+
+				if (!error)
+					error = state->Error;
+			}
+
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+		// f(begin, end) on contiguous slices of [first, last), by default one per pool thread
+		// plus one, claimed in turn by pool jobs and by the calling thread, which returns
+		// once every slice is done. Slices no pool thread has claimed yet are run by the
+		// calling thread, so that ParallelFor may be nested inside pool jobs.
+		template<class F>
+		void ParallelFor(ThreadPool& pool, size_t first, size_t last, const F& f, size_t slices = 0)
+		{
+			struct State
+			{
+				std::mutex              Mutex;
+				std::condition_variable Done;
+				size_t                  Next    = 0;
+				size_t                  Running = 0;
+				std::exception_ptr      Error;
+			};
+
+			if (slices == 0)
+				slices = pool.Size() + 1;
+
+			slices = std::min(slices, last - first);
+
+			if (slices == 0)
+				return;
+
+			const size_t size = (last - first + slices - 1) / slices;
+
+			auto state = std::make_shared<State>();
+
+			// f is only read after a slice was claimed, while the calling thread waits
+			auto work = [state, &f, first, last, size, slices]
+			{
+				while (true)
+				{
+					size_t slice;
+
+					{
+						std::lock_guard<std::mutex> lock(state->Mutex);
+
+						if (state->Next == slices)
+							return;
+
+						slice = state->Next++;
+						state->Running++;
+					}
+
+					try
+					{
+						f(first + slice * size, std::min(first + (slice + 1) * size, last));
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(state->Mutex);
+
+						if (!state->Error)
+							state->Error = std::current_exception();
+					}
+
+					std::lock_guard<std::mutex> lock(state->Mutex);
+
+					if (--state->Running == 0)
+						state->Done.notify_all();
+				}
+			};
+
+			for (size_t s = 1; s < slices; ++s)
+				pool.Post(work);
+
+			work();
+
+			std::unique_lock<std::mutex> lock(state->Mutex);
+
+			state->Done.wait(lock, [&] { return state->Running == 0; });
+
+			if (state->Error)
+				std::rethrow_exception(state->Error);
+		}
+
+		/////////////////////
+		//-- Job control --//
+		/////////////////////
+
+		// Thrown by a job that noticed a cancellation request
+		struct OperationCancelled : std::exception
+		{
+			const char* what() const noexcept override { return "Operation cancelled."; }
+		};
+
+		// Shared between a running job and the Task returned to the caller
+		class JobControl
+		{
+		public:
+			void Cancel() { m_Cancelled = true; }
+
+			bool Cancelled() const { return m_Cancelled; }
+
+			// To be called by the job at its checkpoints
+			void ThrowIfCancelled() const
+			{
+				if (m_Cancelled)
+					throw OperationCancelled();
+			}
+
+			void Report(float progress) { m_Progress = progress; }
+
+			// Between 0 and 1
+			float Progress() const { return m_Progress; }
+
+			bool Done() const
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+
+				return m_Done;
+			}
+
+			// The continuation is run by the thread completing the job, or right away if it is already done
+			void OnComplete(std::function<void()> continuation)
+			{
+				if (!this->Register(continuation))
+					continuation();
+			}
+
+			// The continuation will be run by the thread completing the job, after the ones
+			// registered before it : false if it is already done, the continuation is then
+			// left to the caller
+			bool Register(std::function<void()>& continuation)
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+
+				if (m_Done)
+					return false;
+
+				m_Continuations.push_back(std::move(continuation));
+
+				return true;
+			}
+
+			void Complete()
+			{
+				std::vector<std::function<void()>> continuations;
+
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+
+					m_Done     = true;
+					m_Progress = 1.0f;
+
+					continuations.swap(m_Continuations);
+				}
+
+				for (std::function<void()>& continuation : continuations)
+					continuation();
+			}
+
+		private:
+			std::atomic<bool>                  m_Cancelled{ false };
+			std::atomic<float>                 m_Progress{ 0.0f };
+			mutable std::mutex                 m_Mutex;
+			bool                               m_Done = false;
+			std::vector<std::function<void()>> m_Continuations;
+		};
+
+		//////////////
+		//-- Task --//
+		//////////////
+
+		// Result of an asynchronous operation : a future with cancellation and progress
+		template<typename R>
+		class Task
+		{
+		public:
+			Task(std::future<R> future, std::shared_ptr<JobControl> control) :
+				m_Future(std::move(future)),
+				m_Control(std::move(control))
+			{}
+
+			Task(Task&&)            = default;
+			Task& operator=(Task&&) = default;
+
+			// Blocks until the job is done, rethrows its exception (OperationCancelled included)
+			R Get() { return m_Future.get(); }
+
+			void Wait() const { m_Future.wait(); }
+
+			bool Ready() const { return m_Control->Done(); }
+
+			// Cooperative : the job stops at its next checkpoint
+			void Cancel() { m_Control->Cancel(); }
+
+			float Progress() const { return m_Control->Progress(); }
+
+			// Runs continuation on the completing thread, Get() does not block inside it
+			void Then(std::function<void()> continuation) { m_Control->OnComplete(std::move(continuation)); }
+
+#ifdef LCN_COROUTINES
+			bool await_ready() const { return this->Ready(); }
+
+			// The coroutine is resumed on the pool thread that completed the job. If the job
+			// finished in the meantime, false resumes it right away without nesting a resume.
+			bool await_suspend(std::coroutine_handle<> handle)
+			{
+				std::function<void()> resume = [handle] { handle.resume(); };
+
+				return m_Control->Register(resume);
+			}
+
+			R await_resume() { return this->Get(); }
+#endif
+
+		private:
+			std::future<R>              m_Future;
+			std::shared_ptr<JobControl> m_Control;
+		};
+
+		template<typename R, class F>
+		void RunJob(std::promise<R>& promise, F& job, JobControl& control, std::false_type)
+		{
+			promise.set_value(job(control));
+		}
+
+		template<typename R, class F>
+		void RunJob(std::promise<R>& promise, F& job, JobControl& control, std::true_type)
+		{
+			job(control);
+			promise.set_value();
+		}
+
+		// Runs job(JobControl&) on the pool. Jobs submitted together run concurrently,
+		// each one should call ThrowIfCancelled and Report at its checkpoints.
+		template<class F>
+		auto Run(F job, ThreadPool& pool = ThreadPool::Shared()) -> Task<decltype(job(std::declval<JobControl&>()))>
+		{
+			using R = decltype(job(std::declval<JobControl&>()));
+
+			auto control = std::make_shared<JobControl>();
+			auto promise = std::make_shared<std::promise<R>>();
+
+			Task<R> task(promise->get_future(), control);
+
+			pool.Post([job = std::move(job), control, promise]() mutable
+			{
+				try
+				{
+					control->ThrowIfCancelled();
+
+					RunJob<R>(*promise, job, *control, std::is_void<R>());
+				}
+				catch (...)
+				{
+					promise->set_exception(std::current_exception());
+				}
+
+				control->Complete();
+			});
+
+			return task;
+		}
+	}
+}
@@ -0,0 +1,368 @@
+#pragma once
+
+// Per-kernel counters, compiled out unless LCN_INSTRUMENTATION is defined.
+// LCN_INSTRUMENT(name, lines, columns, flops, bytes) counts one call of the
+// kernel name on a lines x columns operand, and the cycles spent until the
+// end of the enclosing scope. name must be a string literal. Counters are
+// thread local and lock free, Snapshot() merges them.
+
+#ifdef LCN_INSTRUMENTATION
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+#endif
+
+namespace LCNMath {
+	namespace Instrumentation {
+
+		// Kernel is the string literal given to LCN_INSTRUMENT : the hot path compares
+		// pointers only, Snapshot merges equal names coming from different literals.
+		struct KernelKey
+		{
+			const char* Kernel;
+			size_t      Lines;
+			size_t      Columns;
+
+			bool operator<(const KernelKey& other) const
+			{
+				if (int order = std::strcmp(Kernel, other.Kernel))
+					return order < 0;
+
+				if (Lines != other.Lines)
+					return Lines < other.Lines;
+
+				return Columns < other.Columns;
+			}
+		};
+
+		// Flops, Bytes and Cycles are inclusive : a kernel running inside another one
+		// (GaussElimination inside Det or Invert) is counted in both. SelfCycles only
+		// counts the cycles spent outside nested instrumented kernels.
+		struct KernelCounters
+		{
+			uint64_t Calls      = 0;
+			uint64_t Flops      = 0;
+			uint64_t Bytes      = 0;
+			uint64_t Cycles     = 0;
+			uint64_t SelfCycles = 0;
+
+			KernelCounters& operator+=(const KernelCounters& other)
+			{
+				Calls      += other.Calls;
+				Flops      += other.Flops;
+				Bytes      += other.Bytes;
+				Cycles     += other.Cycles;
+				SelfCycles += other.SelfCycles;
+
+				return *this;
+			}
+		};
+
+		struct KernelRecord
+		{
+			KernelKey      Key;
+			KernelCounters Counters;
+		};
+
+		// Time stamp counter where available, nanoseconds otherwise
+		inline uint64_t ReadCycles()
+		{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		class Registry;
+
+		// Open addressing table written by its thread only, without lock : counters are
+		// relaxed atomics so that Snapshot can read them from another thread, a slot
+		// is published by the release store of its name once its shape is written.
+		class ThreadCounters
+		{
+		private:
+			friend class Registry;
+
+			static constexpr size_t Capacity = 1024;
+
+			struct Slot
+			{
+				std::atomic<const char*> Kernel{ nullptr };
+				size_t                   Lines   = 0;
+				size_t                   Columns = 0;
+
+				std::atomic<uint64_t> Calls{ 0 }, Flops{ 0 }, Bytes{ 0 }, Cycles{ 0 }, SelfCycles{ 0 };
+			};
+
+			std::unique_ptr<Slot[]> m_Slots;
+
+			// Shapes beyond the capacity of the table
+			Slot m_Overflow;
+
+			static void Bump(std::atomic<uint64_t>& counter, uint64_t value)
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			}
+
+			Slot& Find(const char* kernel, size_t lines, size_t columns)
+			{
+				uint64_t hash = uint64_t(reinterpret_cast<uintptr_t>(kernel) >> 3) * 0x9E3779B97F4A7C15ull
+				              ^ uint64_t(lines) * 0xC2B2AE3D27D4EB4Full ^ uint64_t(columns) * 0x165667B19E3779F9ull;
+
+				for (size_t probe = 0; probe < Capacity; ++probe)
+				{
+					Slot& slot = m_Slots[size_t(hash + probe) & (Capacity - 1)];
+
+					const char* name = slot.Kernel.load(std::memory_order_relaxed);
+
+					if (name == kernel && slot.Lines == lines && slot.Columns == columns)
+						return slot;
+
+					if (name == nullptr)
+					{
+						slot.Lines   = lines;
+						slot.Columns = columns;
+						slot.Kernel.store(kernel, std::memory_order_release);
+
+						return slot;
+					}
+				}
+
+				return m_Overflow;
+			}
+
+			template<class F>
+			void ForEach(F f) const
+			{
+				auto visit = [&](const Slot& slot)
+				{
+					const char* name = slot.Kernel.load(std::memory_order_acquire);
+
+					if (name == nullptr)
+						return;
+
+					KernelCounters counters;
+
+					counters.Calls      = slot.Calls.load(std::memory_order_relaxed);
+					counters.Flops      = slot.Flops.load(std::memory_order_relaxed);
+					counters.Bytes      = slot.Bytes.load(std::memory_order_relaxed);
+					counters.Cycles     = slot.Cycles.load(std::memory_order_relaxed);
+					counters.SelfCycles = slot.SelfCycles.load(std::memory_order_relaxed);
+
+					f(KernelKey{ name, slot.Lines, slot.Columns }, counters);
+				};
+
+				for (size_t i = 0; i < Capacity; ++i)
+					visit(m_Slots[i]);
+
+				visit(m_Overflow);
+			}
+
+			void Clear()
+			{
+				auto clear = [](Slot& slot)
+				{
+					slot.Calls.store(0, std::memory_order_relaxed);
+					slot.Flops.store(0, std::memory_order_relaxed);
+					slot.Bytes.store(0, std::memory_order_relaxed);
+					slot.Cycles.store(0, std::memory_order_relaxed);
+					slot.SelfCycles.store(0, std::memory_order_relaxed);
+				};
+
+				for (size_t i = 0; i < Capacity; ++i)
+					clear(m_Slots[i]);
+
+				clear(m_Overflow);
+			}
+
+		public:
+			ThreadCounters();
+			~ThreadCounters();
+
+			void Add(const char* kernel, size_t lines, size_t columns, const KernelCounters& counters)
+			{
+				Slot& slot = this->Find(kernel, lines, columns);
+
+				Bump(slot.Calls,      counters.Calls);
+				Bump(slot.Flops,      counters.Flops);
+				Bump(slot.Bytes,      counters.Bytes);
+				Bump(slot.Cycles,     counters.Cycles);
+				Bump(slot.SelfCycles, counters.SelfCycles);
+			}
+
+			static ThreadCounters& Get()
+			{
+				thread_local ThreadCounters counters;
+				return counters;
+			}
+		};
+
+		// Keeps track of every live thread, and of the counters of finished ones.
+		// Its lock is only taken when a thread starts or ends and by Snapshot and Reset.
+		class Registry
+		{
+		private:
+			std::mutex                          m_Lock;
+			std::vector<ThreadCounters*>        m_Threads;
+			std::map<KernelKey, KernelCounters> m_Retired;
+
+		public:
+			static Registry& Get()
+			{
+				static Registry registry;
+				return registry;
+			}
+
+			void Register(ThreadCounters* thread)
+			{
+				std::lock_guard<std::mutex> guard(m_Lock);
+
+				m_Threads.push_back(thread);
+			}
+
+			void Unregister(ThreadCounters* thread)
+			{
+				std::lock_guard<std::mutex> guard(m_Lock);
+
+				thread->ForEach([this](const KernelKey& key, const KernelCounters& counters) { m_Retired[key] += counters; });
+
+				m_Threads.erase(std::remove(m_Threads.begin(), m_Threads.end(), thread), m_Threads.end());
+			}
+
+			std::vector<KernelRecord> Snapshot()
+			{
+				std::lock_guard<std::mutex> guard(m_Lock);
+
+				std::map<KernelKey, KernelCounters> merged = m_Retired;
+
+				for (ThreadCounters* thread : m_Threads)
+					thread->ForEach([&merged](const KernelKey& key, const KernelCounters& counters) { merged[key] += counters; });
+
+				std::vector<KernelRecord> result;
+
+				for (const auto& entry : merged)
+					if (entry.second.Calls != 0)
+						result.push_back({ entry.first, entry.second });
+
+				return result;
+			}
+
+			// Counts of kernels running meanwhile on other threads may be partly kept
+			void Reset()
+			{
+				std::lock_guard<std::mutex> guard(m_Lock);
+
+				m_Retired.clear();
+
+				for (ThreadCounters* thread : m_Threads)
+					thread->Clear();
+			}
+		};
+
+		inline ThreadCounters::ThreadCounters() :
+			m_Slots(new Slot[Capacity])
+		{
+			m_Overflow.Kernel.store("(overflow)", std::memory_order_relaxed);
+
+			Registry::Get().Register(this);
+		}
+
+		inline ThreadCounters::~ThreadCounters() { Registry::Get().Unregister(this); }
+
+		class ScopedKernel
+		{
+		private:
+			const char*    m_Kernel;
+			size_t         m_Lines;
+			size_t         m_Columns;
+			KernelCounters m_Counters;
+			uint64_t       m_Start;
+			uint64_t       m_Nested = 0;
+			ScopedKernel*  m_Parent;
+
+			// Innermost instrumented kernel running on this thread
+			static ScopedKernel*& Current()
+			{
+				thread_local ScopedKernel* current = nullptr;
+				return current;
+			}
+
+		public:
+			ScopedKernel(const char* kernel, size_t lines, size_t columns, uint64_t flops, uint64_t bytes) :
+				m_Kernel(kernel),
+				m_Lines(lines),
+				m_Columns(columns),
+				m_Parent(Current())
+			{
+				m_Counters.Calls = 1;
+				m_Counters.Flops = flops;
+				m_Counters.Bytes = bytes;
+
+				Current() = this;
+
+				m_Start = ReadCycles();
+			}
+
+			ScopedKernel(const ScopedKernel&)            = delete;
+			ScopedKernel& operator=(const ScopedKernel&) = delete;
+
+			~ScopedKernel()
+			{
+				uint64_t cycles = ReadCycles() - m_Start;
+
+				m_Counters.Cycles     = cycles;
+				m_Counters.SelfCycles = cycles > m_Nested ? cycles - m_Nested : 0;
+
+				if (m_Parent)
+					m_Parent->m_Nested += cycles;
+
+				Current() = m_Parent;
+
+				ThreadCounters::Get().Add(m_Kernel, m_Lines, m_Columns, m_Counters);
+			}
+		};
+
+		inline std::vector<KernelRecord> Snapshot() { return Registry::Get().Snapshot(); }
+
+		inline void Reset() { Registry::Get().Reset(); }
+
+		// One CSV line per kernel and shape. flops, bytes and cycles include the nested
+		// kernels, self_cycles does not.
+		inline void Export(std::ostream& stream)
+		{
+			stream << "kernel,lines,columns,calls,flops,bytes,cycles,self_cycles\n";
+
+			for (const KernelRecord& record : Snapshot())
+				stream << record.Key.Kernel << ',' << record.Key.Lines << ',' << record.Key.Columns << ','
+				       << record.Counters.Calls << ',' << record.Counters.Flops << ','
+				       << record.Counters.Bytes << ',' << record.Counters.Cycles << ','
+				       << record.Counters.SelfCycles << '\n';
+		}
+	}
+}
+
+#define LCN_CONCAT_IMPL(A, B) A##B
+#define LCN_CONCAT(A, B) LCN_CONCAT_IMPL(A, B)
+
+#define LCN_INSTRUMENT(NAME, LINES, COLUMNS, FLOPS, BYTES) \
+	LCNMath::Instrumentation::ScopedKernel LCN_CONCAT(lcn_kernel_, __LINE__)(NAME, LINES, COLUMNS, FLOPS, BYTES)
+
+#else
+
+#define LCN_INSTRUMENT(NAME, LINES, COLUMNS, FLOPS, BYTES) ((void)0)
+
+#endif
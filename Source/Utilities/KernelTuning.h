@@ -0,0 +1,198 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace LCNMath {
+	namespace Tuning {
+
+		/////////////////////////
+		//-- Cache detection --//
+		/////////////////////////
+
+		struct CacheInfo
+		{
+			// Data cache sizes in bytes
+			size_t L1 = 32 * 1024;
+			size_t L2 = 256 * 1024;
+			size_t L3 = 8 * 1024 * 1024;
+
+			// Reads /sys/devices/system/cpu/cpu0/cache on Linux, defaults elsewhere
+			static CacheInfo Detect()
+			{
+				CacheInfo result;
+
+				for (int idx = 0; idx < 8; ++idx)
+				{
+					std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(idx) + "/";
+
+					std::ifstream levelfile(dir + "level"), typefile(dir + "type"), sizefile(dir + "size");
+
+					if (!levelfile || !typefile || !sizefile)
+						break;
+
+					int         level;
+					std::string type;
+					size_t      size;
+					char        unit = 0;
+
+					levelfile >> level;
+					typefile  >> type;
+					sizefile  >> size >> unit;
+
+					if (type == "Instruction")
+						continue;
+
+					if (unit == 'K') size *= 1024;
+					if (unit == 'M') size *= 1024 * 1024;
+
+					switch (level)
+					{
+					case 1: result.L1 = size; break;
+					case 2: result.L2 = size; break;
+					case 3: result.L3 = size; break;
+					}
+				}
+
+				return result;
+			}
+		};
+
+		////////////////////////
+		//-- Kernel profile --//
+		////////////////////////
+
+		// Machine dependent parameters of the blocked kernels
+		struct KernelProfile
+		{
+			// Tile edge of the blocked GEMM
+			size_t GemmBlock = 64;
+
+			// Products whose smallest dimension reaches this use Strassen-Winograd, 0 never does
+			size_t StrassenThreshold = 0;
+
+			// Strassen-Winograd switches to the blocked kernel below this size
+			size_t StrassenCrossover = 128;
+
+			// Three double tiles of GemmBlock x GemmBlock should stay in L2
+			static KernelProfile FromCache(const CacheInfo& cache)
+			{
+				KernelProfile result;
+
+				size_t block = 16;
+
+				while (3 * (2 * block) * (2 * block) * sizeof(double) <= cache.L2 && block < 256)
+					block *= 2;
+
+				result.GemmBlock = block;
+
+				return result;
+			}
+
+			// key=value lines, unknown keys are ignored. A value that is not a plain decimal
+			// integer within the range of its key keeps the current one : a bad block size
+			// would hang or crash every product of the process.
+			bool Load(const std::string& path)
+			{
+				std::ifstream file(path);
+
+				if (!file)
+					return false;
+
+				std::string line;
+
+				while (std::getline(file, line))
+				{
+					size_t eq = line.find('=');
+
+					if (eq == std::string::npos)
+						continue;
+
+					std::string key  = Trim(line.substr(0, eq));
+					std::string text = Trim(line.substr(eq + 1));
+
+					if      (key == "GemmBlock")         ParseValue(text, 4, 4096, GemmBlock);
+					else if (key == "StrassenThreshold") ParseValue(text, 0, size_t(1) << 30, StrassenThreshold);
+					else if (key == "StrassenCrossover") ParseValue(text, 16, size_t(1) << 20, StrassenCrossover);
+				}
+
+				return true;
+			}
+
+			bool Save(const std::string& path) const
+			{
+				std::ofstream file(path);
+
+				if (!file)
+					return false;
+
+				file << "GemmBlock="         << GemmBlock         << '\n';
+				file << "StrassenThreshold=" << StrassenThreshold << '\n';
+				file << "StrassenCrossover=" << StrassenCrossover << '\n';
+
+				return bool(file);
+			}
+
+		private:
+			static std::string Trim(const std::string& text)
+			{
+				const char* blanks = " \t\r\n";
+
+				size_t first = text.find_first_not_of(blanks);
+
+				if (first == std::string::npos)
+					return std::string();
+
+				return text.substr(first, text.find_last_not_of(blanks) - first + 1);
+			}
+
+			// value is only written if text is a decimal integer in [min, max]
+			static bool ParseValue(const std::string& text, size_t min, size_t max, size_t& value)
+			{
+				if (text.empty() || text.size() > 18 || text.find_first_not_of("0123456789") != std::string::npos)
+					return false;
+
+				size_t parsed = size_t(std::stoull(text));
+
+				if (parsed < min || parsed > max)
+					return false;
+
+				value = parsed;
+
+				return true;
+			}
+		};
+
+		// Profile used by the kernels. On first use it is loaded from the file named
+		// by the LCNMATH_PROFILE environment variable, or derived from the cache sizes.
+		// Changing it is not thread safe : do it at startup.
+		inline KernelProfile& CurrentProfile()
+		{
+			static KernelProfile profile = []()
+			{
+				KernelProfile result = KernelProfile::FromCache(CacheInfo::Detect());
+
+#ifdef _MSC_VER
+				char*  path   = nullptr;
+				size_t length = 0;
+
+				if (_dupenv_s(&path, &length, "LCNMATH_PROFILE") == 0 && path)
+				{
+					result.Load(path);
+					free(path);
+				}
+#else
+				if (const char* path = std::getenv("LCNMATH_PROFILE"))
+					result.Load(path);
+#endif
+
+				return result;
+			}();
+
+			return profile;
+		}
+	}
+}
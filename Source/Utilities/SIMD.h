@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <cstddef>
+#include <algorithm>
+
+#include "ScalarTypes.h"
+
+// SSE2 is part of every x64 target, x86 builds need /arch:SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define LCN_SSE
+	#include <emmintrin.h>
+#endif
+
+// Half precision conversions (F16C) : GCC and Clang define __F16C__ (-mf16c, -march),
+// MSVC defines no F16C macro but every /arch:AVX2 target has it
+#if defined(LCN_SSE) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define LCN_F16C
+	#include <immintrin.h>
+#endif
+
+namespace LCNMath {
+	namespace SIMD {
+
+		///////////////////////////
+		//-- Scalar reductions --//
+		///////////////////////////
+
+		// Four independent partial sums break the dependency chain of the
+		// accumulation, so that the loop can use the full vector width.
+		// Narrow storage types are widened and summed in their accumulator.
+		template<typename T, typename A = Accumulator<T>>
+		A DotProduct(const T* a, const T* b, size_t n)
+		{
+			A acc0(0), acc1(0), acc2(0), acc3(0);
+
+			size_t i = 0;
+
+			for (; i + 4 <= n; i += 4)
+			{
+				acc0 += A(a[i])     * A(b[i]);
+				acc1 += A(a[i + 1]) * A(b[i + 1]);
+				acc2 += A(a[i + 2]) * A(b[i + 2]);
+				acc3 += A(a[i + 3]) * A(b[i + 3]);
+			}
+
+			for (; i < n; ++i)
+				acc0 += A(a[i]) * A(b[i]);
+
+			return (acc0 + acc1) + (acc2 + acc3);
+		}
+
+		/////////////////////
+		//-- Conversions --//
+		/////////////////////
+
+		// dst[i] = W(src[i]), from a storage type to its accumulator
+		template<typename T, typename W>
+		void Widen(const T* src, W* dst, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				dst[i] = W(src[i]);
+		}
+
+		// dst[i] = T(src[i]), back to the storage type
+		template<typename W, typename T>
+		void Narrow(const W* src, T* dst, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				dst[i] = T(src[i]);
+		}
+
+#ifdef LCN_SSE
+		// A bfloat16 is the upper half of a float : 8 values per register
+		inline void Widen(const BFloat16* src, float* dst, size_t n)
+		{
+			const __m128i zero = _mm_setzero_si128();
+
+			size_t i = 0;
+
+			for (; i + 8 <= n; i += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+				_mm_storeu_ps(dst + i,     _mm_castsi128_ps(_mm_unpacklo_epi16(zero, v)));
+				_mm_storeu_ps(dst + i + 4, _mm_castsi128_ps(_mm_unpackhi_epi16(zero, v)));
+			}
+
+			for (; i < n; ++i)
+				dst[i] = float(src[i]);
+		}
+
+		// Same rounding as the BFloat16 constructor. The shift is arithmetic so that
+		// the signed saturation of the pack keeps every 16 bits pattern.
+		inline void Narrow(const float* src, BFloat16* dst, size_t n)
+		{
+			const __m128i bias = _mm_set1_epi32(0x7FFF);
+			const __m128i one  = _mm_set1_epi32(1);
+			const __m128i qnan = _mm_set1_epi32(0x00400000);
+
+			auto round = [&](__m128 x)
+			{
+				__m128i bits    = _mm_castps_si128(x);
+				__m128i rounded = _mm_add_epi32(_mm_add_epi32(bits, bias), _mm_and_si128(_mm_srli_epi32(bits, 16), one));
+				__m128i nan     = _mm_castps_si128(_mm_cmpunord_ps(x, x));
+
+				rounded = _mm_or_si128(_mm_andnot_si128(nan, rounded), _mm_and_si128(nan, _mm_or_si128(bits, qnan)));
+
+				return _mm_srai_epi32(rounded, 16);
+			};
+
+			size_t i = 0;
+
+			for (; i + 8 <= n; i += 8)
+			{
+				__m128i packed = _mm_packs_epi32(round(_mm_loadu_ps(src + i)), round(_mm_loadu_ps(src + i + 4)));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+			}
+
+			for (; i < n; ++i)
+				dst[i] = BFloat16(src[i]);
+		}
+#endif
+
+#ifdef LCN_F16C
+		inline void Widen(const Half* src, float* dst, size_t n)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(dst + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i))));
+
+			for (; i < n; ++i)
+				dst[i] = float(src[i]);
+		}
+
+		inline void Narrow(const float* src, Half* dst, size_t n)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= n; i += 4)
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+
+			for (; i < n; ++i)
+				dst[i] = Half(src[i]);
+		}
+#endif
+
+		////////////////////////////////
+		//-- Reciprocal square root --//
+		////////////////////////////////
+
+		enum class Precision
+		{
+			Exact,  // Square root and division
+			Fast    // Hardware estimate refined by one Newton-Raphson step, a few ulps for float
+		};
+
+		// 1 / sqrt(x), 0 below the smallest normal number : null vectors stay null instead of
+		// becoming NaN, with a select rather than a branch.
+		template<typename T>
+		T SafeInverseSqrt(T x)
+		{
+			T inv = T(1) / std::sqrt(std::max(x, std::numeric_limits<T>::min()));
+
+			return x >= std::numeric_limits<T>::min() ? inv : T(0);
+		}
+
+#ifdef LCN_SSE
+		//////////////////////////
+		//-- 4 floats vectors --//
+		//////////////////////////
+
+		// Lanes are (x, y, z, w)
+		#define LCN_SHUFFLE(V, X, Y, Z, W) _mm_shuffle_ps(V, V, _MM_SHUFFLE(W, Z, Y, X))
+
+		// a ^ b on (x, y, z), w is a.w * b.w - a.w * b.w
+		inline __m128 Cross3(__m128 a, __m128 b)
+		{
+			__m128 a_yzx = LCN_SHUFFLE(a, 1, 2, 0, 3);
+			__m128 b_yzx = LCN_SHUFFLE(b, 1, 2, 0, 3);
+
+			__m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+
+			return LCN_SHUFFLE(c, 1, 2, 0, 3);
+		}
+
+		// Horizontal sum broadcast in every lane
+		inline __m128 HorizontalSum(__m128 v)
+		{
+			__m128 s = _mm_add_ps(v, LCN_SHUFFLE(v, 1, 0, 3, 2));
+
+			return _mm_add_ps(s, LCN_SHUFFLE(s, 2, 3, 0, 1));
+		}
+
+		inline __m128 Dot4(__m128 a, __m128 b)
+		{
+			return HorizontalSum(_mm_mul_ps(a, b));
+		}
+
+		// Dot product of (x, y, z), w is ignored
+		inline __m128 Dot3(__m128 a, __m128 b)
+		{
+			const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+			return HorizontalSum(_mm_and_ps(_mm_mul_ps(a, b), mask));
+		}
+
+		// r (3 - x r^2) / 2 doubles the 12 bits of the hardware estimate
+		inline __m128 FastInverseSqrt(__m128 x)
+		{
+			__m128 r = _mm_rsqrt_ps(x);
+
+			__m128 xrr = _mm_mul_ps(_mm_mul_ps(x, r), r);
+
+			return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.0f), xrr));
+		}
+
+		// SafeInverseSqrt on each lane. The precision is the same for a whole batch,
+		// so its test is always predicted.
+		inline __m128 SafeInverseSqrt(__m128 x, Precision precision)
+		{
+			const __m128 smallest = _mm_set1_ps(std::numeric_limits<float>::min());
+
+			__m128 valid   = _mm_cmpge_ps(x, smallest);
+			__m128 clamped = _mm_max_ps(x, smallest);
+
+			__m128 inv = precision == Precision::Fast ? FastInverseSqrt(clamped) : _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(clamped));
+
+			return _mm_and_ps(inv, valid);
+		}
+
+		// sqrt(x) on each lane, x (1 / sqrt(x)) in fast mode
+		inline __m128 Sqrt(__m128 x, Precision precision)
+		{
+			return precision == Precision::Fast ? _mm_mul_ps(x, SafeInverseSqrt(x, precision)) : _mm_sqrt_ps(x);
+		}
+
+		#undef LCN_SHUFFLE
+#endif
+	}
+}
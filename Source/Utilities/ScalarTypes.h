@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <complex>
+#include <cstring>
+
+namespace LCNMath {
+
+	// Storage types : values are kept narrow in memory and computed on in float (Half,
+	// BFloat16) or in a wider integer (Fixed). Every operator widens, computes and narrows
+	// back, so long reductions should accumulate in Accumulator<T> instead.
+
+	/////////////////////////////
+	//-- IEEE half precision --//
+	/////////////////////////////
+
+	// binary16 : 1 sign bit, 5 exponent bits, 10 mantissa bits, largest finite value 65504
+	struct Half
+	{
+		uint16_t Bits;
+
+		Half() = default;
+
+		// Rounded to nearest even, overflows to infinity
+		explicit Half(float value)
+		{
+			uint32_t f;
+			std::memcpy(&f, &value, sizeof(f));
+
+			uint32_t sign = f & 0x80000000u;
+			f ^= sign;
+
+			uint32_t h;
+
+			if (f >= 0x47800000u)
+			{
+				// 65536 and above, infinity or NaN
+				h = f > 0x7F800000u ? 0x7E00u : 0x7C00u;
+			}
+			else if (f < 0x38800000u)
+			{
+				// Below the smallest normal half : the addition aligns the 10 bits of the
+				// subnormal mantissa at the bottom of the float and rounds them to nearest even
+				const uint32_t magicbits = 126u << 23;
+
+				float magic, aligned;
+				std::memcpy(&magic, &magicbits, sizeof(magic));
+				std::memcpy(&aligned, &f, sizeof(aligned));
+
+				aligned += magic;
+
+				std::memcpy(&h, &aligned, sizeof(h));
+				h -= magicbits;
+			}
+			else
+			{
+				// Rebias the exponent and round the 13 dropped bits to nearest even
+				f += 0xC8000FFFu + ((f >> 13) & 1u);
+				h = f >> 13;
+			}
+
+			Bits = uint16_t(h | (sign >> 16));
+		}
+
+		operator float() const
+		{
+			const uint32_t shiftedexponent = 0x7C00u << 13;
+
+			uint32_t f        = uint32_t(Bits & 0x7FFFu) << 13;
+			uint32_t exponent = f & shiftedexponent;
+
+			f += (127u - 15u) << 23;
+
+			if (exponent == shiftedexponent)
+			{
+				// Infinity or NaN
+				f += (128u - 16u) << 23;
+			}
+			else if (exponent == 0)
+			{
+				// Zero or subnormal, renormalized by the float unit
+				const uint32_t magicbits = 113u << 23;
+
+				float value, magic;
+
+				f += 1u << 23;
+
+				std::memcpy(&value, &f, sizeof(value));
+				std::memcpy(&magic, &magicbits, sizeof(magic));
+
+				value -= magic;
+
+				std::memcpy(&f, &value, sizeof(f));
+			}
+
+			f |= uint32_t(Bits & 0x8000u) << 16;
+
+			float result;
+			std::memcpy(&result, &f, sizeof(result));
+
+			return result;
+		}
+
+		static Half FromBits(uint16_t bits)
+		{
+			Half h;
+			h.Bits = bits;
+			return h;
+		}
+
+		Half& operator+=(Half other) { return *this = Half(float(*this) + float(other)); }
+		Half& operator-=(Half other) { return *this = Half(float(*this) - float(other)); }
+		Half& operator*=(Half other) { return *this = Half(float(*this) * float(other)); }
+		Half& operator/=(Half other) { return *this = Half(float(*this) / float(other)); }
+
+		Half operator-() const { return FromBits(uint16_t(Bits ^ 0x8000u)); }
+	};
+
+	inline Half operator+(Half a, Half b) { return a += b; }
+	inline Half operator-(Half a, Half b) { return a -= b; }
+	inline Half operator*(Half a, Half b) { return a *= b; }
+	inline Half operator/(Half a, Half b) { return a /= b; }
+
+	static_assert(sizeof(Half) == 2, "Half must be stored in 16 bits.");
+
+	//////////////////
+	//-- BFloat16 --//
+	//////////////////
+
+	// The upper half of a float : same range, 8 bits of mantissa
+	struct BFloat16
+	{
+		uint16_t Bits;
+
+		BFloat16() = default;
+
+		// Rounded to nearest even, NaN stays NaN
+		explicit BFloat16(float value)
+		{
+			uint32_t f;
+			std::memcpy(&f, &value, sizeof(f));
+
+			if ((f & 0x7FFFFFFFu) > 0x7F800000u)
+				Bits = uint16_t((f >> 16) | 0x0040u);
+			else
+				Bits = uint16_t((f + 0x7FFFu + ((f >> 16) & 1u)) >> 16);
+		}
+
+		operator float() const
+		{
+			uint32_t f = uint32_t(Bits) << 16;
+
+			float result;
+			std::memcpy(&result, &f, sizeof(result));
+
+			return result;
+		}
+
+		static BFloat16 FromBits(uint16_t bits)
+		{
+			BFloat16 b;
+			b.Bits = bits;
+			return b;
+		}
+
+		BFloat16& operator+=(BFloat16 other) { return *this = BFloat16(float(*this) + float(other)); }
+		BFloat16& operator-=(BFloat16 other) { return *this = BFloat16(float(*this) - float(other)); }
+		BFloat16& operator*=(BFloat16 other) { return *this = BFloat16(float(*this) * float(other)); }
+		BFloat16& operator/=(BFloat16 other) { return *this = BFloat16(float(*this) / float(other)); }
+
+		BFloat16 operator-() const { return FromBits(uint16_t(Bits ^ 0x8000u)); }
+	};
+
+	inline BFloat16 operator+(BFloat16 a, BFloat16 b) { return a += b; }
+	inline BFloat16 operator-(BFloat16 a, BFloat16 b) { return a -= b; }
+	inline BFloat16 operator*(BFloat16 a, BFloat16 b) { return a *= b; }
+	inline BFloat16 operator/(BFloat16 a, BFloat16 b) { return a /= b; }
+
+	static_assert(sizeof(BFloat16) == 2, "BFloat16 must be stored in 16 bits.");
+
+	/////////////////////
+	//-- Fixed point --//
+	/////////////////////
+
+	template<typename S> struct WiderInteger;
+	template<> struct WiderInteger<int8_t>  { using type = int16_t; };
+	template<> struct WiderInteger<int16_t> { using type = int32_t; };
+	template<> struct WiderInteger<int32_t> { using type = int64_t; };
+	template<> struct WiderInteger<int64_t> { using type = int64_t; };
+
+	// Raw / 2^F in a signed integer S. Products and quotients go through the wider
+	// integer, int64_t storage has no wider type and can overflow there.
+	template<int F, typename S = int32_t>
+	struct Fixed
+	{
+		using Wide = typename WiderInteger<S>::type;
+
+		static constexpr double One = double(int64_t(1) << F);
+
+		S Raw;
+
+		Fixed() = default;
+
+		// Rounded to nearest
+		explicit Fixed(double value) :
+			Raw(S(std::llround(value * One)))
+		{}
+
+		// Same scale, other storage : exact unless the value does not fit in S
+		template<typename S2>
+		explicit Fixed(Fixed<F, S2> other) :
+			Raw(S(other.Raw))
+		{}
+
+		operator double() const { return double(Raw) / One; }
+
+		static Fixed FromRaw(S raw)
+		{
+			Fixed f;
+			f.Raw = raw;
+			return f;
+		}
+
+		Fixed& operator+=(Fixed other) { Raw = S(Raw + other.Raw); return *this; }
+		Fixed& operator-=(Fixed other) { Raw = S(Raw - other.Raw); return *this; }
+
+		// Rounded to nearest
+		Fixed& operator*=(Fixed other)
+		{
+			Wide product = Wide(Raw) * Wide(other.Raw);
+
+			Raw = S(F > 0 ? (product + (Wide(1) << (F > 0 ? F - 1 : 0))) >> F : product);
+
+			return *this;
+		}
+
+		Fixed& operator/=(Fixed other)
+		{
+			Raw = S(Wide(Raw) * (Wide(1) << F) / Wide(other.Raw));
+
+			return *this;
+		}
+
+		Fixed operator-() const { return FromRaw(S(-Raw)); }
+	};
+
+	template<int F, typename S>
+	constexpr double Fixed<F, S>::One;
+
+	template<int F, typename S> Fixed<F, S> operator+(Fixed<F, S> a, Fixed<F, S> b) { return a += b; }
+	template<int F, typename S> Fixed<F, S> operator-(Fixed<F, S> a, Fixed<F, S> b) { return a -= b; }
+	template<int F, typename S> Fixed<F, S> operator*(Fixed<F, S> a, Fixed<F, S> b) { return a *= b; }
+	template<int F, typename S> Fixed<F, S> operator/(Fixed<F, S> a, Fixed<F, S> b) { return a /= b; }
+
+	/////////////////////
+	//-- Accumulator --//
+	/////////////////////
+
+	// Accumulator : type in which sums of products of T are carried (dot products, GEMM)
+	// Real : type of abs(T), in which pivots are compared and norms are computed
+	template<typename T>
+	struct ScalarTraits
+	{
+		using Accumulator = T;
+		using Real        = T;
+	};
+
+	template<>
+	struct ScalarTraits<Half>
+	{
+		using Accumulator = float;
+		using Real        = Half;
+	};
+
+	template<>
+	struct ScalarTraits<BFloat16>
+	{
+		using Accumulator = float;
+		using Real        = BFloat16;
+	};
+
+#ifdef __FLT16_MANT_DIG__
+	// Native half precision of GCC and Clang
+	template<>
+	struct ScalarTraits<_Float16>
+	{
+		using Accumulator = float;
+		using Real        = _Float16;
+	};
+#endif
+
+	template<int F, typename S>
+	struct ScalarTraits<Fixed<F, S>>
+	{
+		using Accumulator = Fixed<F, typename WiderInteger<S>::type>;
+		using Real        = Fixed<F, S>;
+	};
+
+	template<typename T>
+	struct ScalarTraits<std::complex<T>>
+	{
+		using Accumulator = std::complex<typename ScalarTraits<T>::Accumulator>;
+		using Real        = T;
+	};
+
+	template<typename T>
+	using Accumulator = typename ScalarTraits<T>::Accumulator;
+
+	template<typename T>
+	using RealScalar = typename ScalarTraits<T>::Real;
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include "Async.h"
+
+namespace LCNMath {
+	namespace Async {
+
+		////////////////////
+		//-- Task graph --//
+		////////////////////
+
+		// Dependency graph of jobs, executed by a set of workers with work stealing.
+		// Each worker runs the jobs it made ready last in, first out (hot caches) and
+		// steals the oldest jobs of the others when idle. Critical jobs go through a
+		// shared queue served first, which gives lookahead : the critical path of a
+		// factorization (next panel) starts as soon as its inputs are ready, while the
+		// rest of the trailing update is still running. Workers with nothing to run
+		// sleep until a job becomes ready.
+		class TaskGraph
+		{
+		public:
+			using Node = size_t;
+
+			Node Add(std::function<void()> job, bool critical = false)
+			{
+				m_Tasks.push_back({ std::move(job), {}, 0, critical });
+
+				return m_Tasks.size() - 1;
+			}
+
+			// node cannot start before dependency is done
+			void Depend(Node node, Node dependency)
+			{
+				m_Tasks[dependency].Dependents.push_back(node);
+				m_Tasks[node].Dependencies++;
+			}
+
+			size_t Size() const { return m_Tasks.size(); }
+
+			// Runs every job, the calling thread being one of the workers and the others
+			// borrowed from pool (all of them by default). Rethrows the first exception
+			// thrown by a job, jobs not started yet are then skipped.
+			//
+			// The calling thread alone can run the whole graph : Execute does not wait for
+			// pool threads that are busy elsewhere, so it may be called from a pool job.
+			void Execute(size_t threads = 0, ThreadPool& pool = ThreadPool::Shared())
+			{
+				if (threads == 0 || threads > pool.Size() + 1)
+					threads = pool.Size() + 1;
+
+				threads = std::max<size_t>(1, std::min(threads, m_Tasks.size()));
+
+				std::vector<std::atomic<size_t>> remaining(m_Tasks.size());
+				std::vector<WorkQueue>           queues(threads);
+				WorkQueue                        critical;
+
+				m_Remaining  = &remaining;
+				m_Queues     = &queues;
+				m_Critical   = &critical;
+				m_Unfinished = m_Tasks.size();
+				m_Ready      = 0;
+				m_Failed     = false;
+				m_Error      = nullptr;
+
+				size_t next = 0;
+
+				for (Node node = 0; node < m_Tasks.size(); ++node)
+				{
+					remaining[node] = m_Tasks[node].Dependencies;
+
+					if (m_Tasks[node].Dependencies == 0)
+						this->Push(node, next++ % threads);
+				}
+
+				// Pool jobs that start after the graph is done leave without touching it
+				auto helpers = std::make_shared<Helpers>();
+
+				for (size_t w = 1; w < threads; ++w)
+					pool.Post([this, helpers, w]
+					{
+						{
+							std::lock_guard<std::mutex> lock(helpers->Mutex);
+
+							if (helpers->Closed)
+								return;
+
+							helpers->Active++;
+						}
+
+						this->Work(w);
+
+						std::lock_guard<std::mutex> lock(helpers->Mutex);
+
+						if (--helpers->Active == 0)
+							helpers->Done.notify_one();
+					});
+
+				this->Work(0);
+
+				{
+					std::unique_lock<std::mutex> lock(helpers->Mutex);
+
+					helpers->Closed = true;
+					helpers->Done.wait(lock, [&] { return helpers->Active == 0; });
+				}
+
+				if (m_Error)
+					std::rethrow_exception(m_Error);
+			}
+
+		private:
+			struct Task
+			{
+				std::function<void()> Job;
+				std::vector<Node>     Dependents;
+				size_t                Dependencies;
+				bool                  Critical;
+			};
+
+			struct WorkQueue
+			{
+				std::mutex       Mutex;
+				std::deque<Node> Nodes;
+			};
+
+			// Pool threads running a worker of the current Execute
+			struct Helpers
+			{
+				std::mutex              Mutex;
+				std::condition_variable Done;
+				size_t                  Active = 0;
+				bool                    Closed = false;
+			};
+
+			void Push(Node node, size_t worker)
+			{
+				WorkQueue& queue = m_Tasks[node].Critical ? *m_Critical : (*m_Queues)[worker];
+
+				m_Ready++;
+
+				{
+					std::lock_guard<std::mutex> lock(queue.Mutex);
+
+					queue.Nodes.push_back(node);
+				}
+
+				this->Wake(false);
+			}
+
+			// Taken by the sleeping workers so that a wake up cannot be missed
+			void Wake(bool all)
+			{
+				std::lock_guard<std::mutex> lock(m_IdleMutex);
+
+				if (all)
+					m_Idle.notify_all();
+				else
+					m_Idle.notify_one();
+			}
+
+			static bool PopFront(WorkQueue& queue, Node& node)
+			{
+				std::lock_guard<std::mutex> lock(queue.Mutex);
+
+				if (queue.Nodes.empty())
+					return false;
+
+				node = queue.Nodes.front();
+				queue.Nodes.pop_front();
+
+				return true;
+			}
+
+			static bool PopBack(WorkQueue& queue, Node& node)
+			{
+				std::lock_guard<std::mutex> lock(queue.Mutex);
+
+				if (queue.Nodes.empty())
+					return false;
+
+				node = queue.Nodes.back();
+				queue.Nodes.pop_back();
+
+				return true;
+			}
+
+			bool Pop(size_t worker, Node& node)
+			{
+				std::vector<WorkQueue>& queues = *m_Queues;
+
+				bool found = PopFront(*m_Critical, node) || PopBack(queues[worker], node);
+
+				for (size_t i = 1; !found && i < queues.size(); ++i)
+					found = PopFront(queues[(worker + i) % queues.size()], node);
+
+				if (found)
+					m_Ready--;
+
+				return found;
+			}
+
+			void Work(size_t worker)
+			{
+				while (m_Unfinished > 0 && !m_Failed)
+				{
+					Node node;
+
+					if (!this->Pop(worker, node))
+					{
+						std::unique_lock<std::mutex> lock(m_IdleMutex);
+
+						m_Idle.wait(lock, [this] { return m_Ready > 0 || m_Unfinished == 0 || m_Failed; });
+						continue;
+					}
+
+					try
+					{
+						m_Tasks[node].Job();
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(m_ErrorMutex);
+
+						if (!m_Error)
+							m_Error = std::current_exception();
+
+						m_Failed = true;
+
+						this->Wake(true);
+
+						return;
+					}
+
+					for (Node dependent : m_Tasks[node].Dependents)
+						if (--(*m_Remaining)[dependent] == 0)
+							this->Push(dependent, worker);
+
+					if (--m_Unfinished == 0)
+						this->Wake(true);
+				}
+			}
+
+			std::vector<Task> m_Tasks;
+
+			// Execution state
+			std::vector<std::atomic<size_t>>* m_Remaining = nullptr;
+			std::vector<WorkQueue>*           m_Queues    = nullptr;
+			WorkQueue*                        m_Critical  = nullptr;
+			std::atomic<size_t>               m_Unfinished{ 0 };
+			std::atomic<size_t>               m_Ready{ 0 };
+			std::atomic<bool>                 m_Failed{ false };
+			std::mutex                        m_ErrorMutex;
+			std::exception_ptr                m_Error;
+
+			// Idle workers
+			std::mutex                        m_IdleMutex;
+			std::condition_variable           m_Idle;
+		};
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Angles.h"
+#include "SIMD.h"
+
+namespace LCNMath {
+	namespace Trigonometry {
+
+		enum class TrigMode
+		{
+			Exact, // std::sin and std::cos
+			Fast   // Polynomial approximation, see FastSinCos
+		};
+
+		///////////////////////
+		//-- Exact sin/cos --//
+		///////////////////////
+
+		// One call site per function on the same argument, so that compilers
+		// can fuse them into a single sincos call.
+		template<typename T>
+		inline void SinCos(T a, T& s, T& c)
+		{
+			s = std::sin(a);
+			c = std::cos(a);
+		}
+
+		//////////////////////
+		//-- Fast sin/cos --//
+		//////////////////////
+
+		// Reduction to [-pi/4, pi/4] then minimax polynomials (Cephes single precision).
+		// For |a| <= 1e4 rad the absolute error is below 1e-7 in float and 3e-9 in
+		// double : the polynomials are accurate to float precision whatever T is.
+		template<typename T>
+		inline void FastSinCos(T a, T& s, T& c)
+		{
+			// pi / 2 split in three parts, the first two are exact in float
+			const T PIO2_1 = T(1.5703125);
+			const T PIO2_2 = T(4.837512969970703125e-4);
+			const T PIO2_3 = T(7.54978995489188216e-8);
+
+			T q = std::nearbyint(a * T(0.636619772367581343));
+			T r = ((a - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+			T r2 = r * r;
+
+			T ps = r + r * r2 * (T(-1.6666654611e-1) + r2 * (T(8.3321608736e-3) + r2 * T(-1.9515295891e-4)));
+			T pc = T(1) - T(0.5) * r2 + r2 * r2 * (T(4.166664568298827e-2) + r2 * (T(-1.388731625493765e-3) + r2 * T(2.443315711809948e-5)));
+
+			// Quadrant : a = q * pi / 2 + r
+			int64_t quadrant = static_cast<int64_t>(q) & 3;
+
+			T sr = (quadrant & 1) ? pc : ps;
+			T cr = (quadrant & 1) ? ps : pc;
+
+			s = (quadrant & 2) ? -sr : sr;
+			c = ((quadrant + 1) & 2) ? -cr : cr;
+		}
+
+#ifdef LCN_SSE
+		// Same as FastSinCos on 4 float angles at once
+		inline void FastSinCos(__m128 a, __m128& s, __m128& c)
+		{
+			const __m128 PIO2_1 = _mm_set1_ps(1.5703125f);
+			const __m128 PIO2_2 = _mm_set1_ps(4.837512969970703125e-4f);
+			const __m128 PIO2_3 = _mm_set1_ps(7.54978995489188216e-8f);
+
+			// Rounds to nearest with the default MXCSR mode
+			__m128i qi = _mm_cvtps_epi32(_mm_mul_ps(a, _mm_set1_ps(0.636619772367581343f)));
+			__m128  q  = _mm_cvtepi32_ps(qi);
+
+			__m128 r  = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(a, _mm_mul_ps(q, PIO2_1)), _mm_mul_ps(q, PIO2_2)), _mm_mul_ps(q, PIO2_3));
+			__m128 r2 = _mm_mul_ps(r, r);
+
+			__m128 ps = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)), _mm_set1_ps(8.3321608736e-3f));
+			ps = _mm_add_ps(_mm_mul_ps(ps, r2), _mm_set1_ps(-1.6666654611e-1f));
+			ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, r2), r), r);
+
+			__m128 pc = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f)), _mm_set1_ps(-1.388731625493765e-3f));
+			pc = _mm_add_ps(_mm_mul_ps(pc, r2), _mm_set1_ps(4.166664568298827e-2f));
+			pc = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(pc, r2), r2), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)));
+
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i two = _mm_set1_epi32(2);
+
+			// Branchless quadrant handling : swap then flip the sign bits
+			__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(qi, one), one));
+
+			__m128 sr = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+			__m128 cr = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+
+			__m128 ssign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(qi, two), 30));
+			__m128 csign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(qi, one), two), 30));
+
+			s = _mm_xor_ps(sr, ssign);
+			c = _mm_xor_ps(cr, csign);
+		}
+#endif
+
+		///////////////////////////
+		//-- Quantized sin/cos --//
+		///////////////////////////
+
+		// Angles of the form step * 360 / Steps degrees read from a table filled
+		// once in double precision : no error beyond the final rounding to T.
+		template<typename T, size_t Steps = 360>
+		class SinCosTable
+		{
+		private:
+			T m_Sin[Steps];
+			T m_Cos[Steps];
+
+			SinCosTable()
+			{
+				for (size_t i = 0; i < Steps; ++i)
+				{
+					double a = 2.0 * Angles::Pi<double> * double(i) / double(Steps);
+
+					m_Sin[i] = T(std::sin(a));
+					m_Cos[i] = T(std::cos(a));
+				}
+			}
+
+		public:
+			static const SinCosTable& Get()
+			{
+				static SinCosTable table;
+				return table;
+			}
+
+			// Any integer step, negative ones included
+			void SinCos(int64_t step, T& s, T& c) const
+			{
+				int64_t idx = step % int64_t(Steps);
+
+				if (idx < 0)
+					idx += Steps;
+
+				s = m_Sin[idx];
+				c = m_Cos[idx];
+			}
+		};
+	}
+}
@@ -66,8 +66,8 @@ private:
 public:
 	T operator[](size_t i) const
 	{
-		size_t ip1 = (i + 1) % 3;
-		size_t ip2 = (i + 2) % 3;
+		size_t ip1 = (i == 2 ? 0 : i + 1);
+		size_t ip2 = (i == 0 ? 2 : i - 1);
 
 		return el(ip1, 0) * er(ip2, 0) - el(ip2, 0) * er(ip1, 0);
 	}
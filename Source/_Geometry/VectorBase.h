@@ -3,6 +3,7 @@
 #include <cmath>
 
 #include "_Matrix/StaticMatrixBase.h"
+#include "Utilities/ScalarTypes.h"
 
 template<class Derived, typename T, size_t N>
 class VectorBase : public StaticMatrixBase<Derived, T, N, 1>
@@ -26,13 +27,27 @@ public:
 	}
 };
 
-template<class E, typename T, size_t N>
-T operator|(const VectorBase<E, T, N>& a, const VectorBase<E, T, N>& b)
+// Four partial sums so that long vectors keep several multiplications in flight,
+// carried in the accumulator of narrow storage types
+template<class EL, class ER, typename T, size_t N>
+T operator|(const VectorBase<EL, T, N>& a, const VectorBase<ER, T, N>& b)
 {
-	T dotproduct = 0;
+	using A = LCNMath::Accumulator<T>;
 
-	for (size_t i = 0; i < N; ++i)
-		dotproduct += a[i] * b[i];
+	A acc0(0), acc1(0), acc2(0), acc3(0);
 
-	return dotproduct;
+	size_t i = 0;
+
+	for (; i + 4 <= N; i += 4)
+	{
+		acc0 += A(a[i])     * A(b[i]);
+		acc1 += A(a[i + 1]) * A(b[i + 1]);
+		acc2 += A(a[i + 2]) * A(b[i + 2]);
+		acc3 += A(a[i + 3]) * A(b[i + 3]);
+	}
+
+	for (; i < N; ++i)
+		acc0 += A(a[i]) * A(b[i]);
+
+	return T((acc0 + acc1) + (acc2 + acc3));
 }
\ No newline at end of file
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <utility>
+#include <type_traits>
+
+#include "ExpressionTraits.h"
+
+template<typename T, size_t L, size_t C>
+class StaticMatrix;
+
+///////////////////////////////
+//-- Expression evaluation --//
+///////////////////////////////
+
+// Products whose elements cost less than this are evaluated element by element,
+// bigger ones go through EvaluateProduct.
+constexpr size_t LazyProductCost = 64;
+
+// Lazy evaluation : each element of e is computed once, straight into dest
+template<class Dest, class E>
+void EvaluateLazy(Dest& dest, const E& e)
+{
+	for (size_t i = 0; i < e.Line(); ++i)
+		for (size_t j = 0; j < e.Column(); ++j)
+			dest(i, j) = e(i, j);
+}
+
+// out = a * b with stored operands. Overloaded for matrix types with a faster kernel.
+template<class Dest, class EL, class ER>
+void EvaluateProduct(Dest& out, const EL& a, const ER& b)
+{
+	for (size_t i = 0; i < a.Line(); ++i)
+		for (size_t j = 0; j < b.Column(); ++j)
+		{
+			auto sum = a(i, 0) * b(0, j);
+
+			for (size_t k = 1; k < a.Column(); ++k)
+				sum += a(i, k) * b(k, j);
+
+			out(i, j) = sum;
+		}
+}
+
+// Where an operand of a product is stored when it has to be materialized :
+// a StaticMatrix if its shape is known, the destination type if that one is
+// dynamic, nowhere (void) otherwise.
+template<class E, class Dest, typename T>
+using OperandStorage = typename std::conditional<
+	(ExpressionTraits<E>::StaticLines != 0 && ExpressionTraits<E>::StaticColumns != 0),
+	StaticMatrix<T, ExpressionTraits<E>::StaticLines, ExpressionTraits<E>::StaticColumns>,
+	typename std::conditional<ExpressionTraits<Dest>::StaticLines == 0, Dest, void>::type>::type;
+
+template<class Dest, class E>
+void AssignExpression(Dest& dest, const E& e);
+
+// Stored matrices, or operands that cannot be materialized, are used in place
+template<class Storage, class E>
+const E& Materialize(const E& e, std::true_type)
+{
+	return e;
+}
+
+// Any other operand is read several times by the product : compute it once
+template<class Storage, class E>
+Storage Materialize(const E& e, std::false_type)
+{
+	Storage result = Storage::Create(e.Line(), e.Column());
+
+	AssignExpression(result, e);
+
+	return result;
+}
+
+template<class Dest, class E, typename T>
+decltype(auto) MaterializeOperand(const E& e)
+{
+	using Storage = OperandStorage<E, Dest, T>;
+	using InPlace = std::integral_constant<bool, ExpressionTraits<E>::ElementCost == 0 || std::is_void<Storage>::value>;
+
+	return Materialize<Storage>(e, InPlace());
+}
+
+template<class E>
+struct IsMatrixMul : std::false_type {};
+
+template<class EL, class ER, typename T>
+struct IsMatrixMul<MatrixMul<EL, ER, T>> : std::true_type {};
+
+// Element (i, j) only reads elements (i, j) of the leaves and of the products
+template<class E>
+struct ElementWiseOverProducts : std::integral_constant<bool, ExpressionTraits<E>::ElementWise> {};
+
+template<class EL, class ER, typename T>
+struct ElementWiseOverProducts<MatrixMul<EL, ER, T>> : std::true_type {};
+
+template<class EL, class ER, typename T>
+struct ElementWiseOverProducts<MatrixAdd<EL, ER, T>> : std::integral_constant<bool, ElementWiseOverProducts<EL>::value && ElementWiseOverProducts<ER>::value> {};
+
+template<class EL, class ER, typename T>
+struct ElementWiseOverProducts<MatrixSub<EL, ER, T>> : ElementWiseOverProducts<MatrixAdd<EL, ER, T>> {};
+
+template<class E, typename T>
+struct ElementWiseOverProducts<MatrixScale<E, T>> : ElementWiseOverProducts<E> {};
+
+template<class E, typename T, typename U>
+struct ElementWiseOverProducts<MatrixCast<E, T, U>> : ElementWiseOverProducts<E> {};
+
+/////////////////////////
+//-- Nested products --//
+/////////////////////////
+
+// View of E where every product reached through additions, subtractions, scalings
+// and casts has been evaluated once, by AssignChain, into its own storage. Any other
+// node is read in place.
+template<class E, class Dest>
+class ProductsEvaluated
+{
+private:
+	const E& e;
+
+public:
+	ProductsEvaluated(const E& e) :
+		e(e)
+	{}
+
+	auto operator()(size_t i, size_t j) const { return e(i, j); }
+};
+
+template<class EL, class ER, typename T, class Dest>
+class ProductsEvaluated<MatrixMul<EL, ER, T>, Dest>
+{
+private:
+	using Product = MatrixMul<EL, ER, T>;
+	using Target  = typename Dest::template Rebind<T>;
+
+	decltype(MaterializeOperand<Target, Product, T>(std::declval<const Product&>())) product;
+
+public:
+	ProductsEvaluated(const Product& e) :
+		product(MaterializeOperand<Target, Product, T>(e))
+	{}
+
+	T operator()(size_t i, size_t j) const { return product(i, j); }
+};
+
+template<class EL, class ER, typename T, class Dest>
+class ProductsEvaluated<MatrixAdd<EL, ER, T>, Dest>
+{
+private:
+	ProductsEvaluated<EL, Dest> el;
+	ProductsEvaluated<ER, Dest> er;
+
+public:
+	ProductsEvaluated(const MatrixAdd<EL, ER, T>& e) :
+		el(e.Left()),
+		er(e.Right())
+	{}
+
+	T operator()(size_t i, size_t j) const { return el(i, j) + er(i, j); }
+};
+
+template<class EL, class ER, typename T, class Dest>
+class ProductsEvaluated<MatrixSub<EL, ER, T>, Dest>
+{
+private:
+	ProductsEvaluated<EL, Dest> el;
+	ProductsEvaluated<ER, Dest> er;
+
+public:
+	ProductsEvaluated(const MatrixSub<EL, ER, T>& e) :
+		el(e.Left()),
+		er(e.Right())
+	{}
+
+	T operator()(size_t i, size_t j) const { return el(i, j) - er(i, j); }
+};
+
+template<class E, typename T, class Dest>
+class ProductsEvaluated<MatrixScale<E, T>, Dest>
+{
+private:
+	ProductsEvaluated<E, Dest> e;
+	T scalefactor;
+
+public:
+	ProductsEvaluated(const MatrixScale<E, T>& scale) :
+		e(scale.Operand()),
+		scalefactor(scale.Factor())
+	{}
+
+	T operator()(size_t i, size_t j) const { return scalefactor * e(i, j); }
+};
+
+template<class E, typename T, typename U, class Dest>
+class ProductsEvaluated<MatrixCast<E, T, U>, Dest>
+{
+private:
+	ProductsEvaluated<E, Dest> e;
+
+public:
+	ProductsEvaluated(const MatrixCast<E, T, U>& cast) :
+		e(cast.Operand())
+	{}
+
+	U operator()(size_t i, size_t j) const { return static_cast<U>(e(i, j)); }
+};
+
+// Small products with a known shape
+template<class Dest, class EL, class ER>
+void EvaluateProduct(Dest& out, const EL& a, const ER& b, std::true_type)
+{
+	EvaluateProduct<Dest, EL, ER>(out, a, b);
+}
+
+// Large or dynamic products : dispatched to the kernel of the destination type
+template<class Dest, class EL, class ER>
+void EvaluateProduct(Dest& out, const EL& a, const ER& b, std::false_type)
+{
+	EvaluateProduct(out, a, b);
+}
+
+template<class Dest, class EL, class ER, typename T>
+void AssignProduct(Dest& dest, const MatrixMul<EL, ER, T>& e)
+{
+	using Traits = ExpressionTraits<MatrixMul<EL, ER, T>>;
+	using Small  = std::integral_constant<bool, (Traits::StaticLines != 0 && Traits::StaticColumns != 0 && Traits::ElementCost <= LazyProductCost)>;
+
+	const auto& a = MaterializeOperand<Dest, EL, T>(e.Left());
+	const auto& b = MaterializeOperand<Dest, ER, T>(e.Right());
+
+	// The destination may be one of the operands
+	Dest result = Dest::Create(e.Line(), e.Column());
+
+	EvaluateProduct(result, a, b, Small());
+
+	dest = std::move(result);
+}
+
+// Element wise expressions without products : lazy evaluation in place
+template<class Dest, class E>
+void AssignExpression(Dest& dest, const E& e, std::integral_constant<int, 0>)
+{
+	EvaluateLazy(dest, e);
+}
+
+template<class Dest, class EL, class ER, typename T>
+void AssignChain(Dest& dest, const MatrixMul<EL, ER, T>& e);
+
+// Products : the chain of factors is reordered (see ProductChain.h), operands are
+// materialized, then the product kernel
+template<class Dest, class E>
+void AssignExpression(Dest& dest, const E& e, std::integral_constant<int, 1>)
+{
+	AssignChain(dest, e);
+}
+
+// Products under element wise nodes : the products are evaluated first, then the
+// rest element by element in place. The destination may be a factor of a product,
+// it is only resized once every product has been computed.
+template<class Dest, class E>
+void AssignExpression(Dest& dest, const E& e, std::integral_constant<int, 2>)
+{
+	const size_t lines   = e.Line();
+	const size_t columns = e.Column();
+
+	const ProductsEvaluated<E, Dest> view(e);
+
+	if (dest.Line() != lines || dest.Column() != columns)
+		dest = Dest::Create(lines, columns);
+
+	for (size_t i = 0; i < lines; ++i)
+		for (size_t j = 0; j < columns; ++j)
+			dest(i, j) = view(i, j);
+}
+
+// Anything else may read the destination : lazy evaluation in a temporary, nested
+// products being evaluated first all the same
+template<class Dest, class E>
+void AssignExpression(Dest& dest, const E& e, std::integral_constant<int, 3>)
+{
+	const ProductsEvaluated<E, Dest> view(e);
+
+	Dest result = Dest::Create(e.Line(), e.Column());
+
+	for (size_t i = 0; i < e.Line(); ++i)
+		for (size_t j = 0; j < e.Column(); ++j)
+			result(i, j) = view(i, j);
+
+	dest = std::move(result);
+}
+
+// Evaluation strategy chosen at compile time from the traits of E
+template<class Dest, class E>
+void AssignExpression(Dest& dest, const E& e)
+{
+	using Traits = ExpressionTraits<E>;
+
+	constexpr int strategy = (Traits::ElementWise && !Traits::ContainsProduct) ? 0 :
+	                         IsMatrixMul<E>::value ? 1 :
+	                         (Traits::ContainsProduct && ElementWiseOverProducts<E>::value) ? 2 : 3;
+
+	AssignExpression(dest, e, std::integral_constant<int, strategy>());
+}
+
+#include "ProductChain.h"
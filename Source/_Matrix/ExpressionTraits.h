@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+
+#include "MatrixExpression.h"
+
+///////////////////////////
+//-- Expression traits --//
+///////////////////////////
+
+// Size assumed for dimensions only known at run time, in cost estimates
+constexpr size_t DynamicDimension = 64;
+
+// Compile time description of an expression :
+// - StaticLines / StaticColumns : shape if known at compile time, 0 otherwise
+// - ElementCost     : estimated FLOPs to compute one element, 0 for stored matrices
+// - ContainsProduct : a MatrixMul appears somewhere in the tree
+// - ElementWise     : element (i, j) only reads elements (i, j) of the leaves,
+//                     so the destination may safely be one of them
+// - Contiguous      : stored matrix with row major contiguous coefficients
+//
+// The primary template describes an unknown expression as conservatively as possible.
+template<class E>
+struct ExpressionTraits
+{
+	static constexpr size_t StaticLines     = 0;
+	static constexpr size_t StaticColumns   = 0;
+	static constexpr size_t ElementCost     = 1;
+	static constexpr bool   ContainsProduct = false;
+	static constexpr bool   ElementWise     = false;
+	static constexpr bool   Contiguous      = false;
+};
+
+template<class EL, class ER>
+struct BinaryElementWiseTraits
+{
+	using TL = ExpressionTraits<EL>;
+	using TR = ExpressionTraits<ER>;
+
+	static constexpr size_t StaticLines     = TL::StaticLines   ? TL::StaticLines   : TR::StaticLines;
+	static constexpr size_t StaticColumns   = TL::StaticColumns ? TL::StaticColumns : TR::StaticColumns;
+	static constexpr size_t ElementCost     = TL::ElementCost + TR::ElementCost + 1;
+	static constexpr bool   ContainsProduct = TL::ContainsProduct || TR::ContainsProduct;
+	static constexpr bool   ElementWise     = TL::ElementWise && TR::ElementWise;
+	static constexpr bool   Contiguous      = false;
+};
+
+template<class EL, class ER, typename T>
+struct ExpressionTraits<MatrixAdd<EL, ER, T>> : BinaryElementWiseTraits<EL, ER>
+{};
+
+template<class EL, class ER, typename T>
+struct ExpressionTraits<MatrixSub<EL, ER, T>> : BinaryElementWiseTraits<EL, ER>
+{};
+
+template<class EL, class ER, typename T>
+struct ExpressionTraits<MatrixMul<EL, ER, T>>
+{
+	using TL = ExpressionTraits<EL>;
+	using TR = ExpressionTraits<ER>;
+
+	static constexpr size_t Inner = TL::StaticColumns ? TL::StaticColumns : (TR::StaticLines ? TR::StaticLines : DynamicDimension);
+
+	static constexpr size_t StaticLines     = TL::StaticLines;
+	static constexpr size_t StaticColumns   = TR::StaticColumns;
+	static constexpr size_t ElementCost     = Inner * (TL::ElementCost + TR::ElementCost + 2);
+	static constexpr bool   ContainsProduct = true;
+	static constexpr bool   ElementWise     = false;
+	static constexpr bool   Contiguous      = false;
+};
+
+template<class E, typename T>
+struct ExpressionTraits<MatrixScale<E, T>>
+{
+	using TE = ExpressionTraits<E>;
+
+	static constexpr size_t StaticLines     = TE::StaticLines;
+	static constexpr size_t StaticColumns   = TE::StaticColumns;
+	static constexpr size_t ElementCost     = TE::ElementCost + 1;
+	static constexpr bool   ContainsProduct = TE::ContainsProduct;
+	static constexpr bool   ElementWise     = TE::ElementWise;
+	static constexpr bool   Contiguous      = false;
+};
+
+template<class E, typename T, typename U>
+struct ExpressionTraits<MatrixCast<E, T, U>> : ExpressionTraits<MatrixScale<E, T>>
+{};
+
+// Traits of stored matrices
+template<size_t L, size_t C>
+struct StoredMatrixTraits
+{
+	static constexpr size_t StaticLines     = L;
+	static constexpr size_t StaticColumns   = C;
+	static constexpr size_t ElementCost     = 0;
+	static constexpr bool   ContainsProduct = false;
+	static constexpr bool   ElementWise     = true;
+	static constexpr bool   Contiguous      = true;
+};
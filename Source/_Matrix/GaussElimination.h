@@ -0,0 +1,382 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "../Utilities/ScalarTypes.h"
+
+////////////////////////////////////////
+//-- Compile time Gauss elimination --//
+////////////////////////////////////////
+
+// Largest augmented matrix (8x8 inverse) for which the elimination is unrolled
+constexpr size_t GaussUnrollMaxLines   = 8;
+constexpr size_t GaussUnrollMaxColumns = 16;
+
+// Approximate cost of a Gauss-Jordan elimination, for instrumentation
+constexpr size_t GaussFlops(size_t L, size_t C) { return 2 * (L < C ? L : C) * L * C; }
+
+template<size_t L, size_t C>
+using UseUnrolledGauss = std::integral_constant<bool, (L <= GaussUnrollMaxLines && C <= GaussUnrollMaxColumns)>;
+
+template<typename T, size_t L, size_t C, size_t J, bool End = (J >= (L < C ? L : C))>
+struct GaussEliminationStep
+{
+	static bool Apply(T(&m)[L][C], T& pseudodet, size_t& permutations)
+	{
+		using std::abs;
+
+		// Recherche du pivot
+		size_t maxpos = J;
+
+		LCNMath::RealScalar<T> max = abs(m[J][J]);
+
+		for (size_t i = J + 1; i < L; ++i)
+		{
+			if (abs(m[i][J]) > max)
+			{
+				max    = abs(m[i][J]);
+				maxpos = i;
+			}
+		}
+
+		if (max == LCNMath::RealScalar<T>(0))
+			return false;
+
+		T pivot = m[maxpos][J];
+
+		pseudodet *= pivot;
+
+		// Columns before J are already zero in every line below the previous pivots
+		if (maxpos != J)
+		{
+			for (size_t k = J; k < C; ++k)
+				std::swap(m[maxpos][k], m[J][k]);
+
+			permutations++;
+		}
+
+		T inv = T(1) / pivot;
+
+		m[J][J] = T(1);
+
+		for (size_t k = J + 1; k < C; ++k)
+			m[J][k] *= inv;
+
+		for (size_t i = 0; i < L; ++i)
+		{
+			if (i == J)
+				continue;
+
+			T factor = m[i][J];
+
+			m[i][J] = T(0);
+
+			for (size_t k = J + 1; k < C; ++k)
+				m[i][k] -= factor * m[J][k];
+		}
+
+		return GaussEliminationStep<T, L, C, J + 1>::Apply(m, pseudodet, permutations);
+	}
+};
+
+template<typename T, size_t L, size_t C, size_t J>
+struct GaussEliminationStep<T, L, C, J, true>
+{
+	static bool Apply(T(&)[L][C], T&, size_t&) { return true; }
+};
+
+// Same contract as MatrixBase::GaussElimination : reduces m in place and returns
+// the determinant of its leading square block, or 0 if a null pivot is met.
+// m should be a local array, so that the compiler can keep it in registers :
+// callers copy their storage in and out once.
+template<typename T, size_t L, size_t C>
+T UnrolledGaussElimination(T(&m)[L][C])
+{
+	static_assert(UseUnrolledGauss<L, C>::value, "Matrix too large for the unrolled Gauss elimination.");
+
+	T      pseudodet(1);
+	size_t permutations = 0;
+
+	if (!GaussEliminationStep<T, L, C, 0>::Apply(m, pseudodet, permutations))
+		return T(0);
+
+	return (permutations % 2 == 0 ? T(1) : T(-1)) * pseudodet;
+}
+
+/////////////////////////////////////////
+//-- Gauss elimination with pivoting --//
+/////////////////////////////////////////
+
+enum class Pivoting
+{
+	Partial,  // Largest element of the pivot column
+	Rook,     // Element largest in both its line and its column
+	Complete  // Largest element of the remaining square block
+};
+
+template<typename T>
+struct GaussResult
+{
+	T Det;
+
+	// Smallest over largest pivot magnitude, 0 if a null pivot is met.
+	// Close to 0 means that the result should not be trusted.
+	LCNMath::RealScalar<T> RCond;
+};
+
+template<typename T, class M>
+void FindPivot(const M& m, size_t j, size_t L, size_t K, Pivoting pivoting, size_t& pi, size_t& pj)
+{
+	using std::abs;
+
+	pi = j;
+	pj = j;
+
+	for (size_t i = j + 1; i < L; ++i)
+		if (abs(m(i, j)) > abs(m(pi, j)))
+			pi = i;
+
+	switch (pivoting)
+	{
+	case Pivoting::Partial:
+		break;
+
+	case Pivoting::Rook:
+		// Alternate line and column searches, the pivot magnitude strictly increases
+		while (true)
+		{
+			size_t nj = pj;
+
+			for (size_t k = j; k < K; ++k)
+				if (abs(m(pi, k)) > abs(m(pi, nj)))
+					nj = k;
+
+			if (nj == pj)
+				break;
+
+			pj = nj;
+
+			size_t ni = pi;
+
+			for (size_t i = j; i < L; ++i)
+				if (abs(m(i, pj)) > abs(m(ni, pj)))
+					ni = i;
+
+			if (ni == pi)
+				break;
+
+			pi = ni;
+		}
+		break;
+
+	case Pivoting::Complete:
+		for (size_t i = j; i < L; ++i)
+			for (size_t k = j; k < K; ++k)
+				if (abs(m(i, k)) > abs(m(pi, pj)))
+				{
+					pi = i;
+					pj = k;
+				}
+		break;
+	}
+}
+
+// Default observer of PivotedGaussElimination
+struct NoGaussObserver
+{
+	void operator()(size_t, size_t) const {}
+};
+
+// Gauss-Jordan elimination of the L x C matrix m. Pivots are searched in the
+// leading min(L, C) columns only, so [A | B] is reduced to [I | A^-1 B]
+// whatever the pivoting mode : column permutations are undone at the end.
+// observer(done, total) is called after each pivot column and may throw to abort.
+template<typename T, class M, class Observer = NoGaussObserver>
+GaussResult<T> PivotedGaussElimination(M& m, size_t L, size_t C, Pivoting pivoting, Observer observer = Observer())
+{
+	using std::abs;
+
+	const size_t K = std::min(L, C);
+
+	std::vector<size_t> colswaps(pivoting == Pivoting::Partial ? 0 : K);
+
+	size_t permutations = 0;
+	T      pseudodet(1);
+
+	// Magnitudes are real for complex T
+	LCNMath::RealScalar<T> minpivot(0);
+	LCNMath::RealScalar<T> maxpivot(0);
+
+	for (size_t j = 0; j < K; ++j)
+	{
+		size_t pi, pj;
+
+		FindPivot<T>(m, j, L, K, pivoting, pi, pj);
+
+		T pivot = m(pi, pj);
+
+		if (pivot == T(0))
+			return { T(0), LCNMath::RealScalar<T>(0) };
+
+		if (pi != j)
+		{
+			for (size_t k = 0; k < C; ++k)
+				std::swap(m(pi, k), m(j, k));
+
+			permutations++;
+		}
+
+		if (pj != j)
+		{
+			for (size_t i = 0; i < L; ++i)
+				std::swap(m(i, pj), m(i, j));
+
+			permutations++;
+		}
+
+		if (!colswaps.empty())
+			colswaps[j] = pj;
+
+		pseudodet *= pivot;
+
+		if (j == 0 || abs(pivot) < minpivot) minpivot = abs(pivot);
+		if (j == 0 || abs(pivot) > maxpivot) maxpivot = abs(pivot);
+
+		T inv = T(1) / pivot;
+
+		m(j, j) = T(1);
+
+		for (size_t k = j + 1; k < C; ++k)
+			m(j, k) *= inv;
+
+		for (size_t i = 0; i < L; ++i)
+		{
+			if (i == j)
+				continue;
+
+			T factor = m(i, j);
+
+			m(i, j) = T(0);
+
+			for (size_t k = j + 1; k < C; ++k)
+				m(i, k) -= factor * m(j, k);
+		}
+
+		observer(j + 1, K);
+	}
+
+	// [A P | B] has been reduced to [I | (A P)^-1 B], the solution is P (A P)^-1 B
+	for (size_t j = colswaps.size(); j-- > 0;)
+		if (colswaps[j] != j)
+			for (size_t k = K; k < C; ++k)
+				std::swap(m(j, k), m(colswaps[j], k));
+
+	return { (permutations % 2 == 0 ? T(1) : T(-1)) * pseudodet, minpivot / maxpivot };
+}
+
+// LU factorization with partial pivoting of the N x N matrix m, in place : the strict
+// lower triangle receives L (unit diagonal), the upper one U, and pivots[j] the line
+// swapped with line j at step j. A third of the work of a Gauss-Jordan inverse.
+template<typename T, class M>
+GaussResult<T> PivotedLU(M& m, size_t N, std::vector<size_t>& pivots)
+{
+	using std::abs;
+
+	pivots.resize(N);
+
+	size_t permutations = 0;
+	T      pseudodet(1);
+
+	LCNMath::RealScalar<T> minpivot(0);
+	LCNMath::RealScalar<T> maxpivot(0);
+
+	for (size_t j = 0; j < N; ++j)
+	{
+		size_t pi = j;
+
+		for (size_t i = j + 1; i < N; ++i)
+			if (abs(m(i, j)) > abs(m(pi, j)))
+				pi = i;
+
+		pivots[j] = pi;
+
+		T pivot = m(pi, j);
+
+		if (pivot == T(0))
+			return { T(0), LCNMath::RealScalar<T>(0) };
+
+		if (pi != j)
+		{
+			for (size_t k = 0; k < N; ++k)
+				std::swap(m(pi, k), m(j, k));
+
+			permutations++;
+		}
+
+		pseudodet *= pivot;
+
+		if (j == 0 || abs(pivot) < minpivot) minpivot = abs(pivot);
+		if (j == 0 || abs(pivot) > maxpivot) maxpivot = abs(pivot);
+
+		T inv = T(1) / pivot;
+
+		for (size_t i = j + 1; i < N; ++i)
+		{
+			T factor = m(i, j) * inv;
+
+			m(i, j) = factor;
+
+			for (size_t k = j + 1; k < N; ++k)
+				m(i, k) -= factor * m(j, k);
+		}
+	}
+
+	return { (permutations % 2 == 0 ? T(1) : T(-1)) * pseudodet, minpivot / maxpivot };
+}
+
+// Max absolute column sum of the L x C block of m starting at column offset
+template<typename T, class M>
+LCNMath::RealScalar<T> NormOne(const M& m, size_t L, size_t C, size_t offset = 0)
+{
+	using std::abs;
+
+	LCNMath::RealScalar<T> result(0);
+
+	for (size_t j = offset; j < offset + C; ++j)
+	{
+		LCNMath::RealScalar<T> sum(0);
+
+		for (size_t i = 0; i < L; ++i)
+			sum += abs(m(i, j));
+
+		result = std::max(result, sum);
+	}
+
+	return result;
+}
+
+// Max absolute line sum of the L x C matrix m
+template<typename T, class M>
+LCNMath::RealScalar<T> NormInf(const M& m, size_t L, size_t C)
+{
+	using std::abs;
+
+	LCNMath::RealScalar<T> result(0);
+
+	for (size_t i = 0; i < L; ++i)
+	{
+		LCNMath::RealScalar<T> sum(0);
+
+		for (size_t j = 0; j < C; ++j)
+			sum += abs(m(i, j));
+
+		result = std::max(result, sum);
+	}
+
+	return result;
+}
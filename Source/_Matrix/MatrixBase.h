@@ -1,8 +1,12 @@
 #pragma once
 
+#include <limits>
 #include <algorithm>
 
 #include "MatrixExpression.h"
+#include "TriangularView.h"
+#include "GaussElimination.h"
+#include "../Utilities/Instrumentation.h"
 
 template<class Derived, typename T>
 class MatrixBase : public MatrixExpression<Derived, T>
@@ -50,6 +54,8 @@ public:
 
 	T GaussElimination()
 	{
+		LCN_INSTRUMENT("GaussElimination", this->Line(), this->Column(), GaussFlops(this->Line(), this->Column()), this->Line() * this->Column() * sizeof(T));
+
 		size_t linepivot    = 0;
 		size_t permutations = 0;
 		T      pseudodet(1);
@@ -57,15 +63,17 @@ public:
 		size_t L = this->Line();
 		size_t C = this->Column();
 
+		using std::abs;
+
 		for (size_t j = 0; j < std::min(L, C); j++)
 		{
 			// Recherche du pivot
-			T   max = 0;
+			LCNMath::RealScalar<T> max(0);
 			int maxpos = 0;
 
 			for (size_t i = linepivot; i < L; i++)
 			{
-				if (std::abs(this->Derived()(i, j)) > max)
+				if (abs(this->Derived()(i, j)) > max)
 				{
 					max = abs(this->Derived()(i, j));
 					maxpos = i;
@@ -73,7 +81,7 @@ public:
 			}
 
 			// maxpos est le pivot
-			if (this->Derived()(maxpos, j) == 0)
+			if (this->Derived()(maxpos, j) == T(0))
 				return T(0);
 
 			pseudodet *= this->Derived()(maxpos, j);
@@ -96,6 +104,13 @@ public:
 		return (permutations % 2 == 0 ? T(1) : T(-1)) * pseudodet;
 	}
 
+	GaussResult<T> GaussElimination(Pivoting pivoting)
+	{
+		LCN_INSTRUMENT("PivotedGaussElimination", this->Line(), this->Column(), GaussFlops(this->Line(), this->Column()), this->Line() * this->Column() * sizeof(T));
+
+		return PivotedGaussElimination<T>(this->Derived(), this->Line(), this->Column(), pivoting);
+	}
+
 	////////////////////////////////////////
 	//-- Square matrix specific methods --//
 	////////////////////////////////////////
@@ -120,16 +135,65 @@ public:
 	{
 		this->AssertSquareMatrix();
 
+		LCN_INSTRUMENT("Det", this->Line(), this->Column(), GaussFlops(this->Line(), this->Column()), this->Line() * this->Column() * sizeof(T));
+
 		Derived temp = *this;
 
 		return temp.GaussElimination();
 	}
 
+	// Throws if the matrix is singular or too ill conditioned for the precision of T
 	Derived Invert() const
 	{
 		this->AssertSquareMatrix();
 
-		auto temp = Derived::Matrix2C();
+		LCN_INSTRUMENT("Invert", this->Line(), this->Column(), GaussFlops(this->Line(), 2 * this->Column()), 2 * this->Line() * this->Column() * sizeof(T));
+
+		auto temp = this->AugmentedIdentity();
+
+		T pseudodet = temp.GaussElimination();
+
+		Derived result = this->RightBlock(temp);
+
+		if (pseudodet == T(0) || this->RCond(result) < std::numeric_limits<LCNMath::RealScalar<T>>::epsilon())
+			throw std::exception("This matrix cannot be inverted.");
+
+		return result;
+	}
+
+	// Only throws if a null pivot is met. rcond receives the reciprocal condition
+	// number in norm 1, so that callers can decide to retry in higher precision.
+	Derived Invert(Pivoting pivoting, LCNMath::RealScalar<T>& rcond) const
+	{
+		this->AssertSquareMatrix();
+
+		LCN_INSTRUMENT("PivotedInvert", this->Line(), this->Column(), GaussFlops(this->Line(), 2 * this->Column()), 2 * this->Line() * this->Column() * sizeof(T));
+
+		auto temp = this->AugmentedIdentity();
+
+		GaussResult<T> gauss = PivotedGaussElimination<T>(temp, temp.Line(), temp.Column(), pivoting);
+
+		if (gauss.Det == T(0))
+			throw std::exception("This matrix cannot be inverted.");
+
+		Derived result = this->RightBlock(temp);
+
+		rcond = this->RCond(result);
+
+		return result;
+	}
+
+	// Reciprocal condition number in norm 1, given the inverse of this matrix
+	LCNMath::RealScalar<T> RCond(const Derived& inverse) const
+	{
+		size_t N = this->Line();
+
+		return LCNMath::RealScalar<T>(1) / (NormOne<T>(this->Derived(), N, N) * NormOne<T>(inverse, N, N));
+	}
+
+	auto AugmentedIdentity() const
+	{
+		auto temp = this->Derived().Matrix2C();
 
 		size_t L = this->Line();
 		size_t C = this->Column();
@@ -142,12 +206,16 @@ public:
 			for (size_t j = C; j < 2 * C; j++)
 				temp(i, j) = (i == j - C ? T(1) : T(0));
 
-		T pseudodet = temp.GaussElimination();
+		return temp;
+	}
 
-		if (std::abs(pseudodet) < T(0.0001))
-			throw std::exception("This matrix cannot be inverted.");
+	template<class M>
+	Derived RightBlock(const M& temp) const
+	{
+		Derived result = this->Derived();
 
-		Derived result;
+		size_t L = result.Line();
+		size_t C = result.Column();
 
 		for (size_t i = 0; i < L; i++)
 			for (size_t j = 0; j < C; j++)
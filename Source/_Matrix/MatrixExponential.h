@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "StaticMatrix.h"
+
+//////////////////////////////
+//-- Fixed size utilities --//
+//////////////////////////////
+
+// C = A * B without expression temporaries, C must not alias A or B
+template<typename T, size_t N>
+void SquareProduct(const StaticMatrix<T, N, N>& A, const StaticMatrix<T, N, N>& B, StaticMatrix<T, N, N>& C)
+{
+	for (size_t i = 0; i < N; ++i)
+	{
+		for (size_t j = 0; j < N; ++j)
+			C(i, j) = T(0);
+
+		for (size_t k = 0; k < N; ++k)
+		{
+			const T a = A(i, k);
+
+			for (size_t j = 0; j < N; ++j)
+				C(i, j) += a * B(k, j);
+		}
+	}
+}
+
+// result = sum of coefficients[k] * terms[k], plus diagonal on the diagonal
+template<typename T, size_t N>
+void SquareCombination(const StaticMatrix<T, N, N>* const* terms, const double* coefficients, size_t count, double diagonal, StaticMatrix<T, N, N>& result)
+{
+	for (size_t i = 0; i < N; ++i)
+		for (size_t j = 0; j < N; ++j)
+		{
+			T sum = (i == j ? T(diagonal) : T(0));
+
+			for (size_t k = 0; k < count; ++k)
+				sum += T(coefficients[k]) * (*terms[k])(i, j);
+
+			result(i, j) = sum;
+		}
+}
+
+////////////////////////////
+//-- Matrix exponential --//
+////////////////////////////
+
+// Numerator coefficients of the diagonal Pade approximants of exp, the denominator
+// having the same ones with alternating signs (Higham, 2005)
+constexpr double PadeCoefficients3[]  = { 120.0, 60.0, 12.0, 1.0 };
+constexpr double PadeCoefficients5[]  = { 30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0 };
+constexpr double PadeCoefficients7[]  = { 17297280.0, 8648640.0, 1995840.0, 277200.0, 25200.0, 1512.0, 56.0, 1.0 };
+constexpr double PadeCoefficients9[]  = { 17643225600.0, 8821612800.0, 2075673600.0, 302702400.0, 30270240.0, 2162160.0, 110880.0, 3960.0, 90.0, 1.0 };
+constexpr double PadeCoefficients13[] = { 64764752532480000.0, 32382376266240000.0, 7771770303897600.0, 1187353796428800.0, 129060195264000.0,
+                                          10559470521600.0, 670442572800.0, 33522128640.0, 1323241920.0, 40840800.0, 960960.0, 16380.0, 182.0, 1.0 };
+
+// Largest norm 1 for which the approximant of each degree is accurate to the unit
+// roundoff, in double and in single precision
+constexpr double PadeThetaDouble[] = { 1.495585217958292e-2, 2.539398330063230e-1, 9.504178996162932e-1, 2.097847961257068, 5.371920351148152 };
+constexpr double PadeThetaSingle[] = { 4.258730016922831e-1, 1.880152677804762, 3.925724783138660 };
+
+// U and V such that the approximant of degree m is (V - U)^-1 (V + U) : U gathers
+// the odd powers of A, V the even ones. A2 = A * A.
+template<typename T, size_t N>
+void PadeTerms(const StaticMatrix<T, N, N>& A, const StaticMatrix<T, N, N>& A2, int m, StaticMatrix<T, N, N>& U, StaticMatrix<T, N, N>& V)
+{
+	StaticMatrix<T, N, N> A4, A6, A8, W;
+
+	const double* b = (m == 3 ? PadeCoefficients3 : m == 5 ? PadeCoefficients5 : m == 7 ? PadeCoefficients7 : m == 9 ? PadeCoefficients9 : PadeCoefficients13);
+
+	if (m >= 5)
+		SquareProduct(A2, A2, A4);
+
+	if (m >= 7)
+		SquareProduct(A4, A2, A6);
+
+	if (m == 13)
+	{
+		// Degree 13 with 6 products : the powers above 6 are factored through A6
+		const StaticMatrix<T, N, N>* powers[] = { &A6, &A4, &A2 };
+
+		const double uhigh[] = { b[13], b[11], b[9] };
+		const double ulow[]  = { b[7], b[5], b[3] };
+		const double vhigh[] = { b[12], b[10], b[8] };
+		const double vlow[]  = { b[6], b[4], b[2] };
+
+		StaticMatrix<T, N, N> Z;
+
+		SquareCombination(powers, uhigh, 3, 0.0, Z);
+		SquareProduct(A6, Z, W);
+		SquareCombination(powers, ulow, 3, b[1], Z);
+
+		for (size_t i = 0; i < N; ++i)
+			for (size_t j = 0; j < N; ++j)
+				W(i, j) += Z(i, j);
+
+		SquareProduct(A, W, U);
+
+		SquareCombination(powers, vhigh, 3, 0.0, Z);
+		SquareProduct(A6, Z, V);
+		SquareCombination(powers, vlow, 3, b[0], Z);
+
+		for (size_t i = 0; i < N; ++i)
+			for (size_t j = 0; j < N; ++j)
+				V(i, j) += Z(i, j);
+
+		return;
+	}
+
+	if (m >= 9)
+		SquareProduct(A6, A2, A8);
+
+	const StaticMatrix<T, N, N>* powers[] = { &A2, &A4, &A6, &A8 };
+
+	const double uodd[]  = { b[3], m >= 5 ? b[5] : 0.0, m >= 7 ? b[7] : 0.0, m >= 9 ? b[9] : 0.0 };
+	const double veven[] = { b[2], m >= 5 ? b[4] : 0.0, m >= 7 ? b[6] : 0.0, m >= 9 ? b[8] : 0.0 };
+
+	const size_t count = size_t(m - 1) / 2;
+
+	SquareCombination(powers, uodd, count, b[1], W);
+	SquareProduct(A, W, U);
+	SquareCombination(powers, veven, count, b[0], V);
+}
+
+// exp(A) by scaling and squaring : A / 2^s is small enough in norm 1 for a Pade
+// approximant of degree at most 13 (7 in single precision), whose result is squared
+// s times. Every intermediate lives on the stack, the only solve is one unrolled
+// Gauss-Jordan elimination on [V - U | V + U] for small N.
+template<typename T, size_t N>
+StaticMatrix<T, N, N> Expm(const StaticMatrix<T, N, N>& A)
+{
+	using Real = LCNMath::RealScalar<T>;
+
+	const bool    single  = std::numeric_limits<Real>::digits <= 24;
+	const double* theta   = single ? PadeThetaSingle : PadeThetaDouble;
+	const int     degrees = single ? 3 : 5;
+
+	const int pade[] = { 3, 5, 7, 9, 13 };
+
+	const double norm = double(NormOne<T>(A, N, N));
+
+	int m = pade[degrees - 1];
+	int s = 0;
+
+	for (int k = 0; k < degrees; ++k)
+		if (norm <= theta[k])
+		{
+			m = pade[k];
+			break;
+		}
+
+	if (norm > theta[degrees - 1])
+		s = int(std::ceil(std::log2(norm / theta[degrees - 1])));
+
+	LCN_INSTRUMENT("Expm", N, N, 2 * N * N * N * (size_t(m + 1) / 2 + s) + GaussFlops(N, 2 * N), N * N * sizeof(T));
+
+	StaticMatrix<T, N, N> scaled, A2, U, V;
+
+	const T scale = T(std::ldexp(1.0, -s));
+
+	for (size_t i = 0; i < N; ++i)
+		for (size_t j = 0; j < N; ++j)
+			scaled(i, j) = A(i, j) * scale;
+
+	SquareProduct(scaled, scaled, A2);
+	PadeTerms(scaled, A2, m, U, V);
+
+	StaticMatrix<T, N, 2 * N> augmented;
+
+	for (size_t i = 0; i < N; ++i)
+		for (size_t j = 0; j < N; ++j)
+		{
+			augmented(i, j)     = V(i, j) - U(i, j);
+			augmented(i, j + N) = V(i, j) + U(i, j);
+		}
+
+	if (augmented.GaussElimination() == T(0))
+		throw std::exception("Matrix exponential : singular Pade denominator.");
+
+	StaticMatrix<T, N, N> result;
+
+	for (size_t i = 0; i < N; ++i)
+		for (size_t j = 0; j < N; ++j)
+			result(i, j) = augmented(i, j + N);
+
+	for (int k = 0; k < s; ++k)
+	{
+		SquareProduct(result, result, U);
+		result = U;
+	}
+
+	return result;
+}
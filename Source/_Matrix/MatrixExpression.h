@@ -69,6 +69,9 @@ public:
 
 	size_t Line()   const { return el.Line(); }
 	size_t Column() const { return el.Column(); }
+
+	const EL& Left()  const { return el; }
+	const ER& Right() const { return er; }
 };
 
 template<class EL, class ER, typename T>
@@ -106,6 +109,9 @@ public:
 
 	size_t Line()   const { return el.Line(); }
 	size_t Column() const { return el.Column(); }
+
+	const EL& Left()  const { return el; }
+	const ER& Right() const { return er; }
 };
 
 template<class EL, class ER, typename T>
@@ -151,6 +157,9 @@ public:
 
 	size_t Line()   const { return el.Line(); }
 	size_t Column() const { return er.Column(); }
+
+	const EL& Left()  const { return el; }
+	const ER& Right() const { return er; }
 };
 
 template<class EL, class ER, typename T>
@@ -191,6 +200,9 @@ public:
 
 	size_t Line()   const { return e.Line(); }
 	size_t Column() const { return e.Column(); }
+
+	const E& Operand() const { return e; }
+	T        Factor()  const { return scalefactor; }
 };
 
 template<class E, typename T>
@@ -207,4 +219,41 @@ MatrixScale<E, T> operator*(T scalefactor, const MatrixExpression<E, T>& e)
 
 #pragma endregion
 
+#pragma region Conversion
+////////////////////
+//-- Conversion --//
+////////////////////
+
+template<class E, typename T, typename U>
+class MatrixCast : public MatrixExpression<MatrixCast<E, T, U>, U>
+{
+private:
+	const E& e;
+
+	MatrixCast(const E& e) :
+		e(e)
+	{}
+
+	template<typename U, class E, typename T>
+	friend MatrixCast<E, T, U> Cast(const MatrixExpression<E, T>&);
+
+public:
+	U operator()(size_t i, size_t j) const
+	{
+		return static_cast<U>(e(i, j));
+	}
+
+	size_t Line()   const { return e.Line(); }
+	size_t Column() const { return e.Column(); }
+
+	const E& Operand() const { return e; }
+};
+
+template<typename U, class E, typename T>
+MatrixCast<E, T, U> Cast(const MatrixExpression<E, T>& e)
+{
+	return MatrixCast<E, T, U>(static_cast<const E&>(e));
+}
+#pragma endregion
+
 #pragma endregion
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include "MatrixBase.h"
+
+//////////////////////////////////////
+//-- Mixed precision linear solve --//
+//////////////////////////////////////
+
+struct RefinementReport
+{
+	size_t Iterations = 0;
+	bool   Converged  = false;
+	bool   FellBack   = false; // A full solve in high precision had to be done
+};
+
+// b = A^-1 b from the factors and pivots of PivotedLU(A)
+template<class M, class B>
+void LUSolve(const M& lu, const std::vector<size_t>& pivots, B& b)
+{
+	for (size_t j = 0; j < pivots.size(); ++j)
+		if (pivots[j] != j)
+			for (size_t k = 0; k < b.Column(); ++k)
+				std::swap(b(j, k), b(pivots[j], k));
+
+	TriangularSolve<TriangularMode::Lower | TriangularMode::UnitDiag>(lu, b);
+	TriangularSolve<TriangularMode::Upper>(lu, b);
+}
+
+// Solves A x = b where A and b hold T values. A is factorized once (LU with partial
+// pivoting) in Low precision, then x is refined with residuals b - A x computed in T,
+// each step costing a matrix-vector product and two triangular solves. If the low
+// precision factors are singular or too ill conditioned for refinement to contract,
+// or the correction stops shrinking, A is factorized again in T.
+template<typename Low = float, class DA, class DB, typename T>
+DB MixedPrecisionSolve(const MatrixBase<DA, T>& A, const MatrixBase<DB, T>& b, RefinementReport* report = nullptr, size_t maxiterations = 10)
+{
+	ASSERT(A.IsSquareMatrix() && A.Line() == b.Line());
+
+	const DA& a   = static_cast<const DA&>(A);
+	const DB& rhs = static_cast<const DB&>(b);
+
+	RefinementReport local;
+	RefinementReport& rep = (report ? *report : local);
+
+	rep = RefinementReport();
+
+	const size_t N = a.Line();
+	const size_t M = rhs.Column();
+
+	const T normA   = NormInf<T>(a, N, N);
+	const T normb   = NormInf<T>(rhs, N, M);
+	const T epsilon = std::numeric_limits<T>::epsilon();
+
+	std::vector<size_t> pivots;
+
+	DB x = rhs;
+
+	typename DA::template Rebind<Low> lulow = Cast<Low>(a);
+
+	GaussResult<Low> low = PivotedLU<Low>(lulow, N, pivots);
+
+	// Pivot ratio below the precision of Low : the corrections would not contract
+	if (low.Det != Low(0) && low.RCond >= std::numeric_limits<LCNMath::RealScalar<Low>>::epsilon())
+	{
+		typename DB::template Rebind<Low> xlow = Cast<Low>(rhs);
+
+		LUSolve(lulow, pivots, xlow);
+
+		x = Cast<T>(xlow);
+
+		T lastcorrection = std::numeric_limits<T>::infinity();
+
+		while (rep.Iterations < maxiterations)
+		{
+			DB residual = rhs - a * x;
+
+			if (NormInf<T>(residual, N, M) <= T(N) * epsilon * (normA * NormInf<T>(x, N, M) + normb))
+			{
+				rep.Converged = true;
+				break;
+			}
+
+			typename DB::template Rebind<Low> dlow = Cast<Low>(residual);
+
+			LUSolve(lulow, pivots, dlow);
+
+			DB correction = Cast<T>(dlow);
+
+			T normcorrection = NormInf<T>(correction, N, M);
+
+			// Refinement contracts linearly when it works at all
+			if (normcorrection > T(0.5) * lastcorrection)
+				break;
+
+			lastcorrection = normcorrection;
+
+			x = x + correction;
+
+			rep.Iterations++;
+		}
+	}
+
+	if (rep.Converged)
+		return x;
+
+	rep.FellBack = true;
+
+	DA lu = a;
+
+	if (PivotedLU<T>(lu, N, pivots).Det == T(0))
+		throw std::exception("This matrix cannot be inverted.");
+
+	x = rhs;
+
+	LUSolve(lu, pivots, x);
+
+	return x;
+}
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <tuple>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "Evaluation.h"
+
+//////////////////////////
+//-- Chain order (DP) --//
+//////////////////////////
+
+// Classic dynamic programming on the chain A0 * ... * A(n-1) where Ai is dims[i] x dims[i+1].
+// cost[i * n + j] receives the minimal number of multiplications for Ai * ... * Aj and
+// split[i * n + j] the index k such that the best order is (Ai..Ak) * (Ak+1..Aj).
+// Ties keep the leftmost split, which is the left to right order.
+template<typename Cost>
+constexpr void ComputeChainOrder(const size_t* dims, size_t n, Cost* cost, size_t* split)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		cost[i * n + i]  = 0;
+		split[i * n + i] = i;
+	}
+
+	for (size_t length = 2; length <= n; ++length)
+	{
+		for (size_t i = 0; i + length <= n; ++i)
+		{
+			size_t j = i + length - 1;
+
+			cost[i * n + j] = std::numeric_limits<Cost>::max();
+
+			for (size_t k = i; k < j; ++k)
+			{
+				Cost c = cost[i * n + k] + cost[(k + 1) * n + j] + Cost(dims[i]) * dims[k + 1] * dims[j + 1];
+
+				if (c < cost[i * n + j])
+				{
+					cost[i * n + j]  = c;
+					split[i * n + j] = k;
+				}
+			}
+		}
+	}
+}
+
+template<size_t N>
+struct ChainTable
+{
+	unsigned long long Cost[N * N];
+	size_t             Split[N * N];
+};
+
+template<size_t N>
+constexpr ChainTable<N> MakeChainTable(const size_t(&dims)[N + 1])
+{
+	ChainTable<N> table{};
+
+	ComputeChainOrder(dims, N, table.Cost, table.Split);
+
+	return table;
+}
+
+// Optimal order of a chain whose dimensions are known at compile time
+template<size_t... D>
+struct StaticChainOrder
+{
+	static constexpr size_t N = sizeof...(D) - 1;
+
+	static constexpr ChainTable<N> Table = MakeChainTable<N>({ D... });
+
+	static constexpr size_t Dim(size_t i)
+	{
+		const size_t dims[] = { D... };
+
+		return dims[i];
+	}
+
+	static constexpr size_t Split(size_t i, size_t j) { return Table.Split[i * N + j]; }
+	static constexpr unsigned long long Cost()        { return Table.Cost[N - 1]; }
+};
+
+template<size_t... D>
+constexpr ChainTable<StaticChainOrder<D...>::N> StaticChainOrder<D...>::Table;
+
+////////////////////////
+//-- Product chains --//
+////////////////////////
+
+// Flattens a tree of MatrixMul into the tuple of its factors, left to right
+template<class E>
+struct ProductChain
+{
+	static std::tuple<const E&> Collect(const E& e)
+	{
+		return std::tuple<const E&>(e);
+	}
+};
+
+template<class EL, class ER, typename T>
+struct ProductChain<MatrixMul<EL, ER, T>>
+{
+	static auto Collect(const MatrixMul<EL, ER, T>& e)
+	{
+		return std::tuple_cat(ProductChain<EL>::Collect(e.Left()), ProductChain<ER>::Collect(e.Right()));
+	}
+};
+
+template<class Leaves, size_t I>
+using ChainFactor = typename std::decay<typename std::tuple_element<I, Leaves>::type>::type;
+
+constexpr bool AllOf() { return true; }
+
+template<class... B>
+constexpr bool AllOf(bool b, B... others) { return b && AllOf(others...); }
+
+template<class Leaves, size_t... Is>
+constexpr bool StaticChain(std::index_sequence<Is...>)
+{
+	return AllOf((ExpressionTraits<ChainFactor<Leaves, Is>>::StaticLines != 0 && ExpressionTraits<ChainFactor<Leaves, Is>>::StaticColumns != 0)...);
+}
+
+template<class Leaves, size_t... Is>
+StaticChainOrder<ExpressionTraits<ChainFactor<Leaves, 0>>::StaticLines, ExpressionTraits<ChainFactor<Leaves, Is>>::StaticColumns...> StaticChainOrderOf(std::index_sequence<Is...>);
+
+#pragma region Static chains
+// Ai * ... * Aj evaluated in the order given by the table, the result shape is known at compile time
+template<class Order, typename T, size_t I, size_t J, bool Leaf = (I == J)>
+struct StaticChainEvaluation
+{
+	static constexpr size_t K = Order::Split(I, J);
+
+	template<class Operands>
+	static StaticMatrix<T, Order::Dim(I), Order::Dim(J + 1)> Apply(const Operands& operands)
+	{
+		const auto& a = StaticChainEvaluation<Order, T, I, K>::Apply(operands);
+		const auto& b = StaticChainEvaluation<Order, T, K + 1, J>::Apply(operands);
+
+		StaticMatrix<T, Order::Dim(I), Order::Dim(J + 1)> result;
+
+		EvaluateProduct(result, a, b);
+
+		return result;
+	}
+};
+
+template<class Order, typename T, size_t I, size_t J>
+struct StaticChainEvaluation<Order, T, I, J, true>
+{
+	template<class Operands>
+	static const auto& Apply(const Operands& operands)
+	{
+		return std::get<I>(operands);
+	}
+};
+
+template<class Dest, class Leaves, typename T, size_t... Is>
+void AssignStaticChain(Dest& dest, const Leaves& leaves, std::index_sequence<Is...> indices)
+{
+	using Order = decltype(StaticChainOrderOf<Leaves>(indices));
+
+	// Factors read several times are computed once
+	std::tuple<decltype(MaterializeOperand<Dest, ChainFactor<Leaves, Is>, T>(std::get<Is>(leaves)))...> operands(
+		MaterializeOperand<Dest, ChainFactor<Leaves, Is>, T>(std::get<Is>(leaves))...);
+
+	auto result = StaticChainEvaluation<Order, T, 0, Order::N - 1>::Apply(operands);
+
+	dest = std::move(result);
+}
+#pragma endregion
+
+#pragma region Dynamic chains
+// Stored factors of the destination type are used in place, the others are evaluated once
+template<class Dest>
+const Dest* ChainOperand(const Dest& m, std::vector<Dest>&)
+{
+	return &m;
+}
+
+template<class Dest, class E>
+const Dest* ChainOperand(const E& e, std::vector<Dest>& owned)
+{
+	owned.push_back(Dest::Create(e.Line(), e.Column()));
+
+	AssignExpression(owned.back(), e);
+
+	return &owned.back();
+}
+
+// Intermediate results only live until the product that consumes them
+template<class Dest>
+Dest EvaluateChainRange(const Dest* const* operands, const size_t* split, size_t n, size_t i, size_t j)
+{
+	size_t k = split[i * n + j];
+
+	Dest left  = Dest::Create(0, 0);
+	Dest right = Dest::Create(0, 0);
+
+	const Dest* a = operands[i];
+	const Dest* b = operands[j];
+
+	if (k > i)
+	{
+		left = EvaluateChainRange(operands, split, n, i, k);
+		a    = &left;
+	}
+
+	if (k + 1 < j)
+	{
+		right = EvaluateChainRange(operands, split, n, k + 1, j);
+		b     = &right;
+	}
+
+	Dest result = Dest::Create(a->Line(), b->Column());
+
+	EvaluateProduct(result, *a, *b);
+
+	return result;
+}
+
+template<class Dest, class Leaves, typename T, size_t... Is>
+void AssignDynamicChain(Dest& dest, const Leaves& leaves, std::index_sequence<Is...>)
+{
+	constexpr size_t n = sizeof...(Is);
+
+	std::vector<Dest> owned;
+	owned.reserve(n);
+
+	const Dest* operands[] = { ChainOperand<Dest>(std::get<Is>(leaves), owned)... };
+
+	size_t dims[n + 1];
+
+	dims[0] = operands[0]->Line();
+
+	for (size_t i = 0; i < n; ++i)
+		dims[i + 1] = operands[i]->Column();
+
+	unsigned long long cost[n * n];
+	size_t             split[n * n];
+
+	ComputeChainOrder(dims, n, cost, split);
+
+	Dest result = EvaluateChainRange(operands, split, n, 0, n - 1);
+
+	dest = std::move(result);
+}
+#pragma endregion
+
+// Two factors, or shapes known neither at compile time nor by the destination : single product
+template<class Dest, class E, class Leaves>
+void AssignChain(Dest& dest, const E& e, const Leaves&, std::integral_constant<int, 0>)
+{
+	AssignProduct(dest, e);
+}
+
+// Every factor has a static shape : order chosen at compile time
+template<class Dest, class EL, class ER, typename T, class Leaves>
+void AssignChain(Dest& dest, const MatrixMul<EL, ER, T>&, const Leaves& leaves, std::integral_constant<int, 1>)
+{
+	AssignStaticChain<Dest, Leaves, T>(dest, leaves, std::make_index_sequence<std::tuple_size<Leaves>::value>());
+}
+
+// Dynamic destination : order chosen at run time from the actual shapes
+template<class Dest, class EL, class ER, typename T, class Leaves>
+void AssignChain(Dest& dest, const MatrixMul<EL, ER, T>&, const Leaves& leaves, std::integral_constant<int, 2>)
+{
+	AssignDynamicChain<Dest, Leaves, T>(dest, leaves, std::make_index_sequence<std::tuple_size<Leaves>::value>());
+}
+
+// dest = A0 * ... * A(n-1) whatever the parenthesization of the expression
+template<class Dest, class EL, class ER, typename T>
+void AssignChain(Dest& dest, const MatrixMul<EL, ER, T>& e)
+{
+	auto leaves = ProductChain<MatrixMul<EL, ER, T>>::Collect(e);
+
+	using Leaves = decltype(leaves);
+
+	constexpr size_t n       = std::tuple_size<Leaves>::value;
+	constexpr bool   fixed   = StaticChain<Leaves>(std::make_index_sequence<n>());
+	constexpr bool   dynamic = ExpressionTraits<Dest>::StaticLines == 0;
+
+	constexpr int strategy = n < 3 ? 0 : (fixed ? 1 : (dynamic ? 2 : 0));
+
+	AssignChain(dest, e, leaves, std::integral_constant<int, strategy>());
+}
@@ -3,6 +3,7 @@
 #include <initializer_list>
 
 #include "StaticMatrixBase.h"
+#include "Evaluation.h"
 
 template<typename T, size_t L, size_t C>
 class StaticMatrix : public StaticMatrixBase<StaticMatrix<T, L, C>, T, L, C>
@@ -12,6 +13,9 @@ public:
 	using PtrType = T*;
 	using RefType = T& ;
 
+	template<typename U>
+	using Rebind = StaticMatrix<U, L, C>;
+
 private:
 	ValType m_Tab[L][C];
 
@@ -41,9 +45,9 @@ public:
 	{
 		ASSERT((this->Line() == other.Line()) && (this->Column() == other.Column()));
 
-		for (size_t i = 0; i < other.Line(); ++i)
-			for (size_t j = 0; j < other.Column(); ++j)
-				m_Tab[i][j] = other(i, j);
+		LCN_INSTRUMENT("StaticMatrix::Assign", L, C, L * C * ExpressionTraits<E>::ElementCost, L * C * sizeof(T));
+
+		AssignExpression(*this, static_cast<const E&>(other));
 	}
 
 	template<class E>
@@ -51,9 +55,11 @@ public:
 	{
 		ASSERT((this->Line() == other.Line()) && (this->Column() == other.Column()));
 
-		for (size_t i = 0; i < other.Line(); ++i)
-			for (size_t j = 0; j < other.Column(); ++j)
-				m_Tab[i][j] = other(i, j);
+		LCN_INSTRUMENT("StaticMatrix::Assign", L, C, L * C * ExpressionTraits<E>::ElementCost, L * C * sizeof(T));
+
+		AssignExpression(*this, static_cast<const E&>(other));
+
+		return *this;
 	}
 
 	RefType operator()(size_t i, size_t j) { return m_Tab[i][j]; }
@@ -63,4 +69,14 @@ public:
 	{
 		return StaticMatrix<ValType, L, 2 * C>();
 	}
+
+	// Uninitialized matrix, the shape is given by the type
+	static StaticMatrix Create(size_t, size_t)
+	{
+		return StaticMatrix();
+	}
 };
+
+template<typename T, size_t L, size_t C>
+struct ExpressionTraits<StaticMatrix<T, L, C>> : StoredMatrixTraits<L, C>
+{};
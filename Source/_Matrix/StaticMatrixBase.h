@@ -10,4 +10,34 @@ public:
 	constexpr size_t Column() const { return C; }
 
 	static void AssertSquareMatrix() { static_assert(L == C, "This is not a square matrix."); }
+
+	using MatrixBase<Derived, T>::GaussElimination;
+
+	// Hides MatrixBase::GaussElimination() : small sizes are unrolled at compile time
+	T GaussElimination() { return GaussElimination(UseUnrolledGauss<L, C>()); }
+
+	T GaussEliminationUnrolled()
+	{
+		LCN_INSTRUMENT("GaussElimination", L, C, GaussFlops(L, C), L * C * sizeof(T));
+
+		T work[L][C];
+
+		for (size_t i = 0; i < L; ++i)
+			for (size_t j = 0; j < C; ++j)
+				work[i][j] = this->Derived()(i, j);
+
+		T result = UnrolledGaussElimination(work);
+
+		for (size_t i = 0; i < L; ++i)
+			for (size_t j = 0; j < C; ++j)
+				this->Derived()(i, j) = work[i][j];
+
+		return result;
+	}
+
+	T GaussEliminationLoop() { return MatrixBase<Derived, T>::GaussElimination(); }
+
+private:
+	T GaussElimination(std::true_type)  { return GaussEliminationUnrolled(); }
+	T GaussElimination(std::false_type) { return GaussEliminationLoop(); }
 };
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+
+#include "ExpressionTraits.h"
+
+/////////////////////////
+//-- Triangular view --//
+/////////////////////////
+
+struct TriangularMode
+{
+	enum : unsigned
+	{
+		Lower    = 1,
+		Upper    = 2,
+		UnitDiag = 4  // Diagonal assumed to be 1, the stored one is not read
+	};
+};
+
+// Forward (Lower) or back (Upper) substitution : b = op(a)^-1 b, for any number of
+// right hand sides. Only the triangle of a given by Mode is read.
+template<unsigned Mode, class E, class M>
+void TriangularSolve(const E& a, M& b)
+{
+	const bool   lower = (Mode & TriangularMode::Lower) != 0;
+	const bool   unit  = (Mode & TriangularMode::UnitDiag) != 0;
+	const size_t N     = a.Line();
+
+	ASSERT(a.Column() == N && b.Line() == N);
+
+	for (size_t n = 0; n < N; ++n)
+	{
+		size_t r = lower ? n : N - 1 - n;
+
+		for (size_t c = (lower ? 0 : r + 1); c < (lower ? r : N); ++c)
+		{
+			auto factor = a(r, c);
+
+			for (size_t j = 0; j < b.Column(); ++j)
+				b(r, j) -= factor * b(c, j);
+		}
+
+		if (!unit)
+		{
+			auto diag = a(r, r);
+
+			if (diag == decltype(diag)(0))
+				throw std::exception("This triangular matrix is singular.");
+
+			for (size_t j = 0; j < b.Column(); ++j)
+				b(r, j) /= diag;
+		}
+	}
+}
+
+template<class E, unsigned Mode, typename T>
+class TriangularView : public MatrixExpression<TriangularView<E, Mode, T>, T>
+{
+	static_assert(((Mode & TriangularMode::Lower) != 0) != ((Mode & TriangularMode::Upper) != 0), "A triangular view is either lower or upper.");
+
+private:
+	const E& e;
+
+	TriangularView(const E& e) :
+		e(e)
+	{}
+
+	template<unsigned Mode, class E, typename T>
+	friend TriangularView<E, Mode, T> Triangular(const MatrixExpression<E, T>&);
+
+public:
+	static constexpr bool Lower = (Mode & TriangularMode::Lower) != 0;
+	static constexpr bool Unit  = (Mode & TriangularMode::UnitDiag) != 0;
+
+	T operator()(size_t i, size_t j) const
+	{
+		if (Unit && i == j)
+			return T(1);
+
+		return (Lower ? j <= i : j >= i) ? e(i, j) : T(0);
+	}
+
+	size_t Line()   const { return e.Line(); }
+	size_t Column() const { return e.Column(); }
+
+	const E& Operand() const { return e; }
+
+	// b = this^-1 b, b being a stored matrix. Blocked for heap matrices.
+	template<class M>
+	void SolveInPlace(M& b) const
+	{
+		TriangularSolve<Mode>(e, b);
+	}
+
+	template<class M>
+	M Solve(M b) const
+	{
+		this->SolveInPlace(b);
+
+		return b;
+	}
+};
+
+template<unsigned Mode, class E, typename T>
+TriangularView<E, Mode, T> Triangular(const MatrixExpression<E, T>& e)
+{
+	return TriangularView<E, Mode, T>(static_cast<const E&>(e));
+}
+
+////////////////////////////
+//-- Triangular product --//
+////////////////////////////
+
+// Triangular view times a matrix : the zero half of the view is skipped
+template<class E, unsigned Mode, class ER, typename T>
+class TriangularProduct : public MatrixExpression<TriangularProduct<E, Mode, ER, T>, T>
+{
+private:
+	using View = TriangularView<E, Mode, T>;
+
+	const View& el;
+	const ER&   er;
+
+	TriangularProduct(const View& el, const ER& er) :
+		el(el),
+		er(er)
+	{}
+
+	template<class E, unsigned Mode, class ER, typename T>
+	friend TriangularProduct<E, Mode, ER, T> operator*(const TriangularView<E, Mode, T>&, const MatrixExpression<ER, T>&);
+
+public:
+	T operator()(size_t i, size_t j) const
+	{
+		const E& a = el.Operand();
+
+		// Columns k of line i inside the triangle, diagonal excluded
+		size_t first = View::Lower ? 0 : i + 1;
+		size_t last  = View::Lower ? std::min(i, a.Column()) : a.Column();
+
+		T result = (i < a.Column()) ? (View::Unit ? er(i, j) : a(i, i) * er(i, j)) : T(0);
+
+		for (size_t k = first; k < last; ++k)
+			result += a(i, k) * er(k, j);
+
+		return result;
+	}
+
+	size_t Line()   const { return el.Line(); }
+	size_t Column() const { return er.Column(); }
+
+	const View& Left()  const { return el; }
+	const ER&   Right() const { return er; }
+};
+
+template<class E, unsigned Mode, class ER, typename T>
+TriangularProduct<E, Mode, ER, T> operator*(const TriangularView<E, Mode, T>& el, const MatrixExpression<ER, T>& er)
+{
+	ASSERT(el.Column() == er.Line());
+
+	return TriangularProduct<E, Mode, ER, T>(el, static_cast<const ER&>(er));
+}
+
+///////////////////////////
+//-- Triangular traits --//
+///////////////////////////
+
+template<class E, unsigned Mode, typename T>
+struct ExpressionTraits<TriangularView<E, Mode, T>> : ExpressionTraits<MatrixScale<E, T>>
+{};
+
+// Half the work of a full product
+template<class E, unsigned Mode, class ER, typename T>
+struct ExpressionTraits<TriangularProduct<E, Mode, ER, T>> : ExpressionTraits<MatrixMul<E, ER, T>>
+{
+	static constexpr size_t ElementCost = ExpressionTraits<MatrixMul<E, ER, T>>::ElementCost / 2;
+};